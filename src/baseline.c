@@ -0,0 +1,96 @@
+#include <stddef.h>
+#include <stdint.h>
+
+#include "baseline.h"
+
+const char* const baseline_metric_names[BASELINE_METRIC_COUNT] = {
+    [BASELINE_CPU_MHZ]    = "CPU MHz",
+    [BASELINE_BANDWIDTH]  = "RDRAM MB/s",
+    [BASELINE_REFRESH]    = "Refresh Hz",
+    [BASELINE_VI_PER_SEC] = "VI/s",
+    [BASELINE_FPS]        = "FPS",
+};
+
+const char* const baseline_verdict_names[BASELINE_UNCHECKED + 1] = {
+    [BASELINE_PASS]      = "PASS",
+    [BASELINE_WARN]      = "WARN",
+    [BASELINE_FAIL]      = "FAIL",
+    [BASELINE_UNCHECKED] = "----",
+};
+
+// Retail consoles all clock the VR4300 at 93.75 MHz and the uncached copy
+// test lands at 500-550 MB/s; only the video timing follows the region.
+// The FPS check is loose, since the render rate also depends on the
+// settings in use, but a unit that cannot hold half the refresh rate fails.
+#define REFS(hz) {                                          \
+    [BASELINE_CPU_MHZ]    = { 93.75f, 1.0f,  3.0f, 0 },     \
+    [BASELINE_BANDWIDTH]  = { 525.0f, 10.0f, 25.0f, 0 },    \
+    [BASELINE_REFRESH]    = { hz,     1.0f,  3.0f, 0 },     \
+    [BASELINE_VI_PER_SEC] = { hz,     3.0f,  10.0f, 0 },    \
+    [BASELINE_FPS]        = { hz,     10.0f, 50.0f, 1 },    \
+}
+
+// No revision or RAM size is known to measure differently yet, so those
+// keys are left open; a specific entry added here takes precedence
+static const BaselineEntry baseline_table[] = {
+    { "NTSC retail",  0, BASELINE_NTSC,       0, REFS(60.0f) },
+    { "PAL retail",   0, BASELINE_PAL,        0, REFS(50.0f) },
+    { "MPAL retail",  0, BASELINE_MPAL,       0, REFS(60.0f) },
+    { "Generic",      0, BASELINE_ANY_REGION, 0, REFS(60.0f) },
+};
+
+#define BASELINE_TABLE_COUNT (int)(sizeof(baseline_table) / sizeof(baseline_table[0]))
+
+const BaselineEntry* baseline_find(const BaselineEntry *table, int count, uint32_t rcp_version,
+                                   BaselineRegion region, uint32_t memory_mb) {
+    const BaselineEntry *best = NULL;
+    int best_score = -1;
+
+    for (int i = 0; i < count; i++) {
+        const BaselineEntry *e = &table[i];
+        int score = 0;
+
+        if (e->rcp_version) {
+            if (e->rcp_version != rcp_version) continue;
+            score += 4;
+        }
+        if (e->region != BASELINE_ANY_REGION) {
+            if (e->region != region) continue;
+            score += 2;
+        }
+        if (e->memory_mb) {
+            if (e->memory_mb != memory_mb) continue;
+            score += 1;
+        }
+
+        // Ties go to the earlier entry
+        if (score > best_score) {
+            best = e;
+            best_score = score;
+        }
+    }
+    return best;
+}
+
+const BaselineEntry* baseline_select(uint32_t rcp_version, BaselineRegion region, uint32_t memory_mb) {
+    return baseline_find(baseline_table, BASELINE_TABLE_COUNT, rcp_version, region, memory_mb);
+}
+
+BaselineCheck baseline_check(const BaselineRef *ref, float value) {
+    BaselineCheck check = { 0.0f, BASELINE_UNCHECKED };
+
+    if (ref->expected <= 0.0f || value <= 0.0f) {
+        return check;
+    }
+
+    check.deviation_pct = (value - ref->expected) * 100.0f / ref->expected;
+
+    float off = check.deviation_pct < 0.0f ? -check.deviation_pct : check.deviation_pct;
+    if (ref->low_only && check.deviation_pct > 0.0f) {
+        off = 0.0f;
+    }
+
+    check.verdict = (off > ref->fail_pct) ? BASELINE_FAIL :
+                    (off > ref->warn_pct) ? BASELINE_WARN : BASELINE_PASS;
+    return check;
+}
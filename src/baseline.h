@@ -0,0 +1,65 @@
+#ifndef BASELINE_H
+#define BASELINE_H
+
+#include <stdint.h>
+
+// Reference results of known-good consoles. The running unit is matched to
+// the most specific entry for its RCP revision, region and RAM size, and
+// each checked metric is graded by its deviation from that entry.
+typedef enum {
+    BASELINE_CPU_MHZ = 0,
+    BASELINE_BANDWIDTH,     // MB/s, uncached copy test
+    BASELINE_REFRESH,       // Hz reported by the video interface
+    BASELINE_VI_PER_SEC,    // Measured VI interrupts per second
+    BASELINE_FPS,
+    BASELINE_METRIC_COUNT
+} BaselineMetric;
+
+typedef enum {
+    BASELINE_NTSC = 0,
+    BASELINE_PAL,
+    BASELINE_MPAL,
+    BASELINE_ANY_REGION
+} BaselineRegion;
+
+typedef enum {
+    BASELINE_PASS = 0,
+    BASELINE_WARN,
+    BASELINE_FAIL,
+    BASELINE_UNCHECKED      // No reference, or nothing measured yet
+} BaselineVerdict;
+
+typedef struct {
+    float expected;         // 0: not checked
+    float warn_pct;         // Deviations beyond these, in percent
+    float fail_pct;
+    uint8_t low_only;       // Only a shortfall counts
+} BaselineRef;
+
+typedef struct {
+    const char *name;
+    uint32_t rcp_version;   // MI_VERSION, 0 matches any
+    uint8_t region;         // BaselineRegion
+    uint8_t memory_mb;      // 0 matches any
+    BaselineRef refs[BASELINE_METRIC_COUNT];
+} BaselineEntry;
+
+typedef struct {
+    float deviation_pct;
+    BaselineVerdict verdict;
+} BaselineCheck;
+
+extern const char* const baseline_metric_names[BASELINE_METRIC_COUNT];
+extern const char* const baseline_verdict_names[BASELINE_UNCHECKED + 1];
+
+// Most specific entry of a table matching the console, or NULL. A key that
+// an entry leaves open matches anything but ranks below an exact match.
+const BaselineEntry* baseline_find(const BaselineEntry *table, int count, uint32_t rcp_version,
+                                   BaselineRegion region, uint32_t memory_mb);
+
+// The same over the built-in table, which always has a match
+const BaselineEntry* baseline_select(uint32_t rcp_version, BaselineRegion region, uint32_t memory_mb);
+
+BaselineCheck baseline_check(const BaselineRef *ref, float value);
+
+#endif /* BASELINE_H */
@@ -0,0 +1,23 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <libdragon.h>
+
+// On-demand benchmark shown on the Bench tab.
+// Benchmarks disturb the live measurements, so they only run when
+// the user presses A, and keep their results until the next run.
+typedef struct {
+    const char *name;
+    const char *short_name;                             // At most 7 characters, for tables
+    int pages;                                          // Result pages (D-Left/D-Right)
+    void (*run)(void);
+    void (*draw)(display_context_t disp, int y, int page);
+
+    // Headline result of the last run, kept across power cycles (results.c)
+    const char *score_name;
+    const char *score_unit;
+    int lower_is_better;
+    float (*score)(void);
+} Benchmark;
+
+#endif /* BENCH_H */
@@ -0,0 +1,151 @@
+#include <libdragon.h>
+#include <stdio.h>
+#include <stdint.h>
+
+#include "bench_fmt.h"
+#include "fmt.h"
+#include "hw.h"
+#include "ui.h"
+
+// Fields formatted per measurement; the minimum of the samples is reported
+#define FMT_FIELDS   64
+#define FMT_SAMPLES  8
+
+typedef enum {
+    FMT_CASE_INTEGER = 0,
+    FMT_CASE_MHZ,
+    FMT_CASE_MBPS,
+    FMT_CASE_HEX,
+    FMT_CASE_LABEL,
+    FMT_CASE_COUNT
+} FmtCase;
+
+static const char *fmt_case_names[FMT_CASE_COUNT] = {
+    "%lu",
+    "%.2f MHz",
+    "%lu MB/s",
+    "0x%08lX",
+    "%-20s : "
+};
+
+// Inputs are read through volatile so nothing is folded at compile time
+static volatile uint32_t int_inputs[4] = { 7, 4096, 93750000, 4294967295u };
+static volatile float float_inputs[4] = { 62.5f, 93.75f, 93.7421f, 187.5f };
+
+typedef struct {
+    uint32_t snprintf_cycles;   // CPU cycles per field
+    uint32_t fmt_cycles;
+} FmtResult;
+
+static FmtResult fmt_results[FMT_CASE_COUNT];
+static int has_results = 0;
+
+static void format_snprintf(FmtCase c, char *buffer, int i) {
+    switch (c) {
+        case FMT_CASE_INTEGER:
+            snprintf(buffer, FMT_MAX, "%lu", (unsigned long)int_inputs[i & 3]);
+            break;
+        case FMT_CASE_MHZ:
+            snprintf(buffer, FMT_MAX, "%.2f MHz", float_inputs[i & 3]);
+            break;
+        case FMT_CASE_MBPS:
+            snprintf(buffer, FMT_MAX, "%lu MB/s", (unsigned long)int_inputs[i & 3]);
+            break;
+        case FMT_CASE_HEX:
+            snprintf(buffer, FMT_MAX, "0x%08lX", (unsigned long)int_inputs[i & 3]);
+            break;
+        case FMT_CASE_LABEL:
+            snprintf(buffer, FMT_MAX, "%-20s : ", "Core Speed");
+            break;
+        case FMT_CASE_COUNT:
+            break;
+    }
+}
+
+static void format_fmt(FmtCase c, char *buffer, int i) {
+    switch (c) {
+        case FMT_CASE_INTEGER:
+            fmt_u32(buffer, int_inputs[i & 3]);
+            break;
+        case FMT_CASE_MHZ:
+            fmt_mhz(buffer, float_inputs[i & 3]);
+            break;
+        case FMT_CASE_MBPS:
+            fmt_mbps(buffer, int_inputs[i & 3]);
+            break;
+        case FMT_CASE_HEX:
+            fmt_hex32(buffer, int_inputs[i & 3]);
+            break;
+        case FMT_CASE_LABEL:
+            fmt_str(fmt_pad(buffer, "Core Speed", 20), " : ");
+            break;
+        case FMT_CASE_COUNT:
+            break;
+    }
+}
+
+// Best of FMT_SAMPLES runs, in CPU cycles per field (COUNT ticks at half rate)
+static uint32_t time_fields(void (*format)(FmtCase, char *, int), FmtCase c) {
+    char buffer[FMT_MAX];
+    uint32_t best = UINT32_MAX;
+
+    for (int s = 0; s < FMT_SAMPLES; s++) {
+        uint32_t start = read_c0_count();
+        for (int i = 0; i < FMT_FIELDS; i++) {
+            format(c, buffer, i);
+        }
+        uint32_t ticks = read_c0_count() - start;
+        if (ticks < best) best = ticks;
+    }
+    return best * 2 / FMT_FIELDS;
+}
+
+static void fmt_run(void) {
+    for (int c = 0; c < FMT_CASE_COUNT; c++) {
+        fmt_results[c].snprintf_cycles = time_fields(format_snprintf, (FmtCase)c);
+        fmt_results[c].fmt_cycles = time_fields(format_fmt, (FmtCase)c);
+    }
+    has_results = 1;
+}
+
+static void fmt_draw(display_context_t disp, int y, int page) {
+    char buffer[64];
+    (void)page;
+
+    if (!has_results) {
+        ui_draw_text(disp, 20, y, "Press A to run");
+        return;
+    }
+
+    ui_draw_text(disp, 15, y, "CPU cycles per field");
+    y += UI_LINE_HEIGHT + 2;
+
+    ui_draw_text(disp, 20, y, "Format       snprintf    fmt  Ratio");
+    y += UI_LINE_HEIGHT;
+
+    for (int c = 0; c < FMT_CASE_COUNT; c++) {
+        const FmtResult *r = &fmt_results[c];
+        float ratio = r->fmt_cycles ? (float)r->snprintf_cycles / r->fmt_cycles : 0.0f;
+        snprintf(buffer, sizeof(buffer), "%-10s  %8lu  %5lu  %4.1fx",
+                 fmt_case_names[c], (unsigned long)r->snprintf_cycles,
+                 (unsigned long)r->fmt_cycles, ratio);
+        ui_draw_text(disp, 20, y, buffer);
+        y += UI_LINE_HEIGHT;
+    }
+}
+
+static float fmt_score(void) {
+    return fmt_results[FMT_CASE_MHZ].fmt_cycles;
+}
+
+const Benchmark bench_fmt = {
+    .name = "Value Formatting",
+    .short_name = "Fmt",
+    .pages = 1,
+    .run = fmt_run,
+    .draw = fmt_draw,
+    .score_name = "fmt %.2f MHz",
+    .score_unit = "cycles",
+    .lower_is_better = 1,
+    .score = fmt_score,
+};
@@ -0,0 +1,9 @@
+#ifndef BENCH_FMT_H
+#define BENCH_FMT_H
+
+#include "bench.h"
+
+// CPU cost of formatting UI values: fmt_* vs snprintf
+extern const Benchmark bench_fmt;
+
+#endif /* BENCH_FMT_H */
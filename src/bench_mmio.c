@@ -0,0 +1,213 @@
+#include <libdragon.h>
+#include <stdio.h>
+#include <stdint.h>
+
+#include "bench_mmio.h"
+#include "hw.h"
+#include "ui.h"
+
+// Samples per measurement; the minimum is reported to reject interference
+#define MMIO_SAMPLES  32
+#define MMIO_BURST    16
+
+#define REPEAT4(x)  x; x; x; x
+#define REPEAT16(x) REPEAT4(x); REPEAT4(x); REPEAT4(x); REPEAT4(x)
+
+// One register per RCP block. Reads are timed on a representative register;
+// writes store back the value just read, so they are timed on a register of
+// the same block where that is a plain store. A DMA only starts when its
+// length register is written, so the DMA address registers qualify.
+typedef enum {
+    MMIO_SP = 0,
+    MMIO_DP,
+    MMIO_MI,
+    MMIO_VI,
+    MMIO_AI,
+    MMIO_PI,
+    MMIO_RI,
+    MMIO_SI,
+    MMIO_REGISTER_COUNT
+} MmioBlock;
+
+typedef struct {
+    const char *block;
+    const char *name;           // Read
+    uint32_t addr;
+    const char *write_name;     // NULL: no register is safe to write back
+    uint32_t write_addr;
+} MmioRegister;
+
+static const MmioRegister mmio_registers[MMIO_REGISTER_COUNT] = {
+    [MMIO_SP] = { "SP", "SP_STATUS",  SP_STATUS_REG,  "SP_MEM_ADDR", 0xA4040000 },
+    // DPC_START arms the next command buffer; STATUS writes are set/clear
+    [MMIO_DP] = { "DP", "DPC_STATUS", DPC_STATUS_REG, NULL,          0 },
+    // MI_VERSION is read-only; MI_MODE and MI_MASK writes are set/clear
+    [MMIO_MI] = { "MI", "MI_VERSION", MI_VERSION_REG, NULL,          0 },
+    [MMIO_VI] = { "VI", "VI_V_INTR",  0xA440000C,     "VI_V_INTR",   0xA440000C },
+    // AI reads all return AI_LEN, but nothing here plays audio and the
+    // address is only used once AI_LEN is written
+    [MMIO_AI] = { "AI", "AI_LEN",     0xA4500004,     "AI_DRAM",     0xA4500000 },
+    [MMIO_PI] = { "PI", "PI_BSD_LAT", 0xA4600014,     "PI_DRAM",     0xA4600000 },
+    [MMIO_RI] = { "RI", "RI_SELECT",  0xA470000C,     "RI_SELECT",   0xA470000C },
+    [MMIO_SI] = { "SI", "SI_DRAM",    0xA4800000,     "SI_DRAM",     0xA4800000 },
+};
+
+#define PI_STATUS_REG  0xA4600010
+#define SI_STATUS_REG  0xA4800018
+
+typedef struct {
+    uint32_t read;          // Single isolated read
+    uint32_t read_burst;    // Per read, back-to-back
+    uint32_t write;         // Write followed by a read-back of the same register, 0 if not timed
+} MmioLatency;
+
+// Results in CPU cycles; the extra row is uncached RDRAM for reference
+static MmioLatency mmio_results[MMIO_REGISTER_COUNT + 1];
+static int has_results = 0;
+
+// Cost of the COUNT bracket itself
+static uint32_t empty_ticks(void) {
+    uint32_t best = UINT32_MAX;
+    for (int i = 0; i < MMIO_SAMPLES; i++) {
+        uint32_t start = read_c0_count();
+        uint32_t end = read_c0_count();
+        if (end - start < best) best = end - start;
+    }
+    return best;
+}
+
+// Readings below the bracket cost count as 0 rather than wrapping
+static uint32_t minus_overhead(uint32_t ticks, uint32_t overhead) {
+    return (ticks > overhead) ? ticks - overhead : 0;
+}
+
+static void measure_read(volatile uint32_t *reg, uint32_t overhead, MmioLatency *out) {
+    uint32_t best_read = UINT32_MAX;
+    uint32_t best_burst = UINT32_MAX;
+
+    for (int i = 0; i < MMIO_SAMPLES; i++) {
+        uint32_t start = read_c0_count();
+        (void)*reg;
+        uint32_t ticks = read_c0_count() - start;
+        if (ticks < best_read) best_read = ticks;
+
+        start = read_c0_count();
+        REPEAT16((void)*reg);
+        ticks = read_c0_count() - start;
+        if (ticks < best_burst) best_burst = ticks;
+    }
+
+    // COUNT ticks at half the CPU clock
+    out->read = minus_overhead(best_read, overhead) * 2;
+    out->read_burst = minus_overhead(best_burst, overhead) * 2 / MMIO_BURST;
+}
+
+// Store + read-back, minus a lone read of the same register
+static uint32_t measure_write(volatile uint32_t *reg, uint32_t overhead) {
+    uint32_t best_read = UINT32_MAX;
+    uint32_t best_write = UINT32_MAX;
+    uint32_t value = *reg;
+
+    for (int i = 0; i < MMIO_SAMPLES; i++) {
+        uint32_t start = read_c0_count();
+        (void)*reg;
+        uint32_t ticks = read_c0_count() - start;
+        if (ticks < best_read) best_read = ticks;
+
+        // The read-back drains the CPU write buffer, so the write is complete
+        start = read_c0_count();
+        *reg = value;
+        (void)*reg;
+        ticks = read_c0_count() - start;
+        if (ticks < best_write) best_write = ticks;
+    }
+
+    uint32_t read = minus_overhead(best_read, overhead) * 2;
+    uint32_t write = minus_overhead(best_write, overhead) * 2;
+    return (write > read) ? write - read : 0;
+}
+
+static void mmio_run(void) {
+    static uint32_t rdram_word __attribute__((aligned(16)));
+    volatile uint32_t *rdram = UncachedAddr(&rdram_word);
+
+    // No RSP, PI or SI DMA may be using the address registers written back
+    rspq_wait();
+    disable_interrupts();
+    while (*(volatile uint32_t *)PI_STATUS_REG & 3);
+    while (*(volatile uint32_t *)SI_STATUS_REG & 3);
+
+    uint32_t overhead = empty_ticks();
+    for (int i = 0; i < MMIO_REGISTER_COUNT; i++) {
+        const MmioRegister *r = &mmio_registers[i];
+        measure_read((volatile uint32_t *)(uintptr_t)r->addr, overhead, &mmio_results[i]);
+        mmio_results[i].write = r->write_name ?
+            measure_write((volatile uint32_t *)(uintptr_t)r->write_addr, overhead) : 0;
+    }
+    measure_read(rdram, overhead, &mmio_results[MMIO_REGISTER_COUNT]);
+    mmio_results[MMIO_REGISTER_COUNT].write = measure_write(rdram, overhead);
+
+    enable_interrupts();
+    has_results = 1;
+}
+
+static void mmio_draw(display_context_t disp, int y, int page) {
+    char buffer[64];
+
+    if (!has_results) {
+        ui_draw_text(disp, 20, y, "Press A to run");
+        return;
+    }
+
+    ui_draw_text(disp, 15, y, page == 0 ? "Read Latency (CPU cycles)" : "Write Latency (CPU cycles)");
+    y += UI_LINE_HEIGHT + 2;
+
+    ui_draw_text(disp, 20, y, page == 0 ? "Blk Register    Read  B2B" : "Blk Register    Write");
+    y += UI_LINE_HEIGHT;
+
+    for (int i = 0; i <= MMIO_REGISTER_COUNT; i++) {
+        const MmioLatency *r = &mmio_results[i];
+        const MmioRegister *reg = (i < MMIO_REGISTER_COUNT) ? &mmio_registers[i] : NULL;
+        const char *block = reg ? reg->block : "--";
+
+        if (page == 0) {
+            snprintf(buffer, sizeof(buffer), "%-3s %-10s %5lu %4lu", block,
+                     reg ? reg->name : "RDRAM", (unsigned long)r->read,
+                     (unsigned long)r->read_burst);
+        } else if (reg && !reg->write_name) {
+            snprintf(buffer, sizeof(buffer), "%-3s %-10s %5s", block, "-", "-");
+        } else {
+            snprintf(buffer, sizeof(buffer), "%-3s %-10s %5lu", block,
+                     reg ? reg->write_name : "RDRAM", (unsigned long)r->write);
+        }
+        ui_draw_text(disp, 20, y, buffer);
+        y += UI_LINE_HEIGHT;
+    }
+
+    y += 3;
+    if (page == 0) {
+        ui_draw_text(disp, 15, y, "B2B: per read in a burst of 16");
+    } else {
+        ui_draw_text(disp, 15, y, "Store + read-back drain, minus read");
+        y += UI_LINE_HEIGHT;
+        ui_draw_text(disp, 15, y, "DP: DPC_START arms the RDP");
+        y += UI_LINE_HEIGHT;
+        ui_draw_text(disp, 15, y, "MI: writes are set/clear commands");
+    }
+}
+
+static float mmio_score(void) {
+    return mmio_results[MMIO_MI].read;
+}
+
+const Benchmark bench_mmio = {
+    .name = "MMIO Latency",
+    .short_name = "MMIO",
+    .pages = 2,
+    .run = mmio_run,
+    .draw = mmio_draw,
+    .score_name = "MI_VERSION read",
+    .score_unit = "cycles",
+    .lower_is_better = 1,
+    .score = mmio_score,
+};
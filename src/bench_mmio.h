@@ -0,0 +1,9 @@
+#ifndef BENCH_MMIO_H
+#define BENCH_MMIO_H
+
+#include "bench.h"
+
+// CPU-side access latency of a representative register in every RCP block
+extern const Benchmark bench_mmio;
+
+#endif /* BENCH_MMIO_H */
@@ -0,0 +1,172 @@
+#include <libdragon.h>
+#include <stdio.h>
+#include <stdint.h>
+
+#include "bench_text.h"
+#include "hw.h"
+#include "text.h"
+#include "ui.h"
+
+// Offscreen target in the current framebuffer format (Color Depth), so the
+// CPU paths write as many bytes per pixel as they do on screen
+#define TEXT_TARGET_W  320
+#define TEXT_TARGET_H  240
+#define TEXT_SCREENS   8
+
+typedef enum {
+    TEXT_CPU = 0,
+    TEXT_CPU_PACKED,
+    TEXT_RDP_DIRECT,
+    TEXT_RDP_BATCHED,
+    TEXT_METHOD_COUNT
+} TextMethod;
+
+static const char *text_method_names[TEXT_METHOD_COUNT] = {
+    "CPU graphics",
+    "CPU packed",
+    "RDP per-glyph",
+    "RDP batched"
+};
+
+// A screenful of typical tab rows
+static const char *sample_lines[] = {
+    "Core Speed           : 93.75 MHz",
+    "Bandwidth            : 512 MB/s",
+    "Code Name            : 0x00000B22",
+    "SP      60     12  0.01%",
+    "Current Scanline     : 417",
+    "Actual FPS           : 59.8 fps",
+    "Frame Count          : 1234567",
+    "Reality Co-Processor",
+    "Texture Formats      : Multiple",
+    "Fill Rate            : ~100 Mpixels/s",
+};
+#define SAMPLE_LINE_COUNT (int)(sizeof(sample_lines) / sizeof(sample_lines[0]))
+
+typedef struct {
+    uint32_t glyphs_per_ms;     // Until the RDP has finished
+    uint32_t cpu_cycles;        // CPU cycles per glyph to draw or issue it
+} TextResult;
+
+static TextResult text_results[TEXT_METHOD_COUNT];
+static int has_results = 0;
+
+static uint32_t count_glyphs(void) {
+    uint32_t glyphs = 0;
+    for (int i = 0; i < SAMPLE_LINE_COUNT; i++) {
+        for (const char *c = sample_lines[i]; *c; c++) {
+            if (*c != ' ') glyphs++;
+        }
+    }
+    return glyphs;
+}
+
+static void draw_screen(surface_t *target, TextMethod method) {
+    // Two columns of sample rows fill the 21 lines of a tab
+    for (int row = 0; row < 2 * SAMPLE_LINE_COUNT; row++) {
+        const char *line = sample_lines[row % SAMPLE_LINE_COUNT];
+        int y = row * UI_LINE_HEIGHT;
+
+        switch (method) {
+            case TEXT_CPU:
+                graphics_draw_text(target, 0, y, line);
+                break;
+            case TEXT_CPU_PACKED:
+                text_draw_packed(target, 0, y, line);
+                break;
+            case TEXT_RDP_DIRECT:
+                text_draw_direct(0, y, line);
+                break;
+            case TEXT_RDP_BATCHED:
+                text_queue(0, y, line);
+                break;
+            case TEXT_METHOD_COUNT:
+                break;
+        }
+    }
+
+    if (method == TEXT_RDP_BATCHED) {
+        text_flush();
+    }
+}
+
+static void text_run(void) {
+    tex_format_t format = (ui_display_depth() == UI_DEPTH_16) ? FMT_RGBA16 : FMT_RGBA32;
+    surface_t target = surface_alloc(format, TEXT_TARGET_W, TEXT_TARGET_H);
+    uint32_t glyphs = count_glyphs() * 2 * TEXT_SCREENS;
+
+    graphics_set_color(0xFFFFFFFF, 0x00000000);
+
+    for (int m = 0; m < TEXT_METHOD_COUNT; m++) {
+        TextMethod method = (TextMethod)m;
+
+        int uses_rdp = (method == TEXT_RDP_DIRECT || method == TEXT_RDP_BATCHED);
+
+        if (uses_rdp) {
+            rdpq_attach(&target, NULL);
+        }
+        rspq_wait();
+
+        uint32_t start = read_c0_count();
+        for (int s = 0; s < TEXT_SCREENS; s++) {
+            draw_screen(&target, method);
+        }
+        uint32_t issued = read_c0_count();
+
+        if (uses_rdp) {
+            rdpq_detach_wait();
+        }
+        uint32_t done = read_c0_count();
+
+        uint32_t us = (done - start) / (TICKS_PER_SECOND / 1000000);
+        if (us == 0) us = 1;
+        text_results[m].glyphs_per_ms = (uint32_t)((uint64_t)glyphs * 1000 / us);
+        text_results[m].cpu_cycles = (issued - start) * 2 / glyphs;
+    }
+
+    surface_free(&target);
+    has_results = 1;
+}
+
+static void text_draw(display_context_t disp, int y, int page) {
+    char buffer[64];
+    (void)page;
+
+    if (!has_results) {
+        ui_draw_text(disp, 20, y, "Press A to run");
+        return;
+    }
+
+    snprintf(buffer, sizeof(buffer), "%lu glyphs per screen", (unsigned long)count_glyphs() * 2);
+    ui_draw_text(disp, 15, y, buffer);
+    y += UI_LINE_HEIGHT + 2;
+
+    ui_draw_text(disp, 20, y, "Method         Glyphs/ms  CPU cyc");
+    y += UI_LINE_HEIGHT;
+
+    for (int m = 0; m < TEXT_METHOD_COUNT; m++) {
+        snprintf(buffer, sizeof(buffer), "%-13s  %9lu  %6lu", text_method_names[m],
+                 (unsigned long)text_results[m].glyphs_per_ms,
+                 (unsigned long)text_results[m].cpu_cycles);
+        ui_draw_text(disp, 20, y, buffer);
+        y += UI_LINE_HEIGHT;
+    }
+
+    y += 3;
+    ui_draw_text(disp, 15, y, "CPU cyc: per glyph, drawn or issued");
+}
+
+static float text_score(void) {
+    return text_results[TEXT_RDP_BATCHED].glyphs_per_ms;
+}
+
+const Benchmark bench_text = {
+    .name = "Text Rendering",
+    .short_name = "Text",
+    .pages = 1,
+    .run = text_run,
+    .draw = text_draw,
+    .score_name = "RDP batched",
+    .score_unit = "glyphs/ms",
+    .score = text_score,
+};
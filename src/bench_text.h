@@ -0,0 +1,9 @@
+#ifndef BENCH_TEXT_H
+#define BENCH_TEXT_H
+
+#include "bench.h"
+
+// Text rendering throughput: CPU graphics_draw_text vs RDP glyph paths
+extern const Benchmark bench_text;
+
+#endif /* BENCH_TEXT_H */
@@ -0,0 +1,262 @@
+#include <libdragon.h>
+#include <stdio.h>
+#include <stdint.h>
+
+#include "bench_tmem.h"
+#include "hw.h"
+#include "ui.h"
+
+// Each load is repeated so the per-batch sync overhead is amortized
+#define TMEM_REPEAT      64
+#define TMEM_SIZE        4096
+#define TMEM_PALETTE     2048   // Upper half of TMEM holds the palette for CI formats
+
+// Source image is wider than any tested texture so that LOAD_TILE can
+// start at an odd texel (row start not 8-byte aligned in RDRAM)
+#define SRC_PITCH_BYTES  (256 + 8)
+#define SRC_ROWS         64
+
+typedef enum {
+    LOAD_BLOCK_ALIGNED = 0,
+    LOAD_BLOCK_UNALIGNED,
+    LOAD_TILE_ALIGNED,
+    LOAD_TILE_UNALIGNED,
+    LOAD_METHOD_COUNT
+} LoadMethod;
+
+typedef struct {
+    const char *name;
+    tex_format_t fmt;
+} TmemFormat;
+
+static const TmemFormat tmem_formats[] = {
+    { "RGBA32", FMT_RGBA32 },
+    { "RGBA16", FMT_RGBA16 },
+    { "IA16",   FMT_IA16 },
+    { "IA8",    FMT_IA8 },
+    { "IA4",    FMT_IA4 },
+    { "I8",     FMT_I8 },
+    { "I4",     FMT_I4 },
+    { "CI8",    FMT_CI8 },
+    { "CI4",    FMT_CI4 },
+};
+#define TMEM_FORMAT_COUNT (int)(sizeof(tmem_formats) / sizeof(tmem_formats[0]))
+
+static const struct { uint16_t w, h; } tmem_sizes[] = {
+    { 16, 16 }, { 32, 32 }, { 64, 32 }, { 64, 64 }, { 128, 64 },
+};
+#define TMEM_SIZE_COUNT (int)(sizeof(tmem_sizes) / sizeof(tmem_sizes[0]))
+
+// TLUT sizes: CI4 palette (16 entries) and CI8 palette (256 entries)
+static const uint16_t tlut_sizes[] = { 16, 256 };
+#define TLUT_SIZE_COUNT (int)(sizeof(tlut_sizes) / sizeof(tlut_sizes[0]))
+
+// Results in bytes per RDP cycle; 0 means "does not fit TMEM"
+static float load_rate[TMEM_FORMAT_COUNT][TMEM_SIZE_COUNT][LOAD_METHOD_COUNT];
+static float tlut_rate[TLUT_SIZE_COUNT];
+static int has_results = 0;
+
+static int is_ci_format(tex_format_t fmt) {
+    return fmt == FMT_CI4 || fmt == FMT_CI8;
+}
+
+static uint32_t texture_bytes(tex_format_t fmt, int w, int h) {
+    return TEX_FORMAT_PIX2BYTES(fmt, w * h);
+}
+
+static int fits_tmem(tex_format_t fmt, int w, int h) {
+    uint32_t limit = is_ci_format(fmt) ? TMEM_PALETTE : TMEM_SIZE;
+    return texture_bytes(fmt, w, h) <= limit;
+}
+
+// 4bpp data cannot be loaded directly: load it as 8bpp with half the width,
+// the same way libdragon's own texture uploader does.
+static tex_format_t load_format(tex_format_t fmt) {
+    switch (fmt) {
+        case FMT_I4:  return FMT_I8;
+        case FMT_IA4: return FMT_IA8;
+        case FMT_CI4: return FMT_CI8;
+        default:      return fmt;
+    }
+}
+
+static int load_width(tex_format_t fmt, int w) {
+    return (TEX_FORMAT_BITDEPTH(fmt) == 4) ? w / 2 : w;
+}
+
+// LOAD_BLOCK moves at most 2048 texels. Like libdragon's uploader, 8bpp
+// data (and 4bpp, loaded as 8bpp) is block-loaded as 16bpp with half the
+// texel count, which keeps every texture that fits TMEM within the limit.
+static tex_format_t block_format(tex_format_t lfmt) {
+    return (TEX_FORMAT_BITDEPTH(lfmt) == 8) ? FMT_RGBA16 : lfmt;
+}
+
+// Bytes per TMEM line of the loaded tile. RGBA32 is split across the high
+// and low TMEM banks, 16 bits of each texel in each, so a line takes half
+// the bytes in either bank.
+static uint16_t tmem_line_bytes(tex_format_t lfmt, int lw) {
+    if (lfmt == FMT_RGBA32) {
+        return TEX_FORMAT_PIX2BYTES(FMT_RGBA16, lw);
+    }
+    return TEX_FORMAT_PIX2BYTES(lfmt, lw);
+}
+
+// Wait for the RDP to go idle, then zero its busy counters
+static void rdp_counters_reset(void) {
+    volatile uint32_t *dpc_status = (uint32_t *)DPC_STATUS_REG;
+    rspq_wait();
+    *dpc_status = DPC_CLR_CMD_CTR | DPC_CLR_CLOCK_CTR;
+}
+
+// Wait for the queued batch to finish and return the RDP busy cycles
+static uint32_t rdp_busy_cycles(void) {
+    volatile uint32_t *dpc_bufbusy = (uint32_t *)DPC_BUFBUSY_REG;
+    rspq_wait();
+    return *dpc_bufbusy & DPC_COUNTER_MASK;
+}
+
+static void issue_load(uint8_t *src, tex_format_t fmt, int w, int h, LoadMethod method) {
+    tex_format_t lfmt = load_format(fmt);
+    int lw = load_width(fmt, w);
+    int src_width = SRC_PITCH_BYTES / TEX_FORMAT_PIX2BYTES(lfmt, 1);
+    int s0 = (method == LOAD_BLOCK_UNALIGNED || method == LOAD_TILE_UNALIGNED) ? 1 : 0;
+    uint16_t tmem_pitch = tmem_line_bytes(lfmt, lw);
+
+    if (method == LOAD_BLOCK_ALIGNED || method == LOAD_BLOCK_UNALIGNED) {
+        // LOAD_BLOCK streams a linear span of texels into TMEM
+        tex_format_t bfmt = block_format(lfmt);
+        int texels = TEX_FORMAT_PIX2BYTES(lfmt, lw * h) / TEX_FORMAT_PIX2BYTES(bfmt, 1);
+
+        rdpq_set_texture_image_raw(0, PhysicalAddr(src), bfmt, texels + 8, 1);
+        rdpq_set_tile(TILE7, bfmt, 0, 0, NULL);
+        rdpq_load_block(TILE7, s0, 0, texels, tmem_pitch);
+    } else {
+        // LOAD_TILE walks a rectangle out of a larger RDRAM image
+        rdpq_set_texture_image_raw(0, PhysicalAddr(src), lfmt, src_width, SRC_ROWS);
+        rdpq_set_tile(TILE7, lfmt, 0, tmem_pitch, NULL);
+        rdpq_load_tile(TILE7, s0, 0, s0 + lw, h);
+    }
+}
+
+static void issue_tlut(uint8_t *src, int colors) {
+    rdpq_set_texture_image_raw(0, PhysicalAddr(src), FMT_RGBA16, colors, 1);
+    rdpq_set_tile(TILE7, FMT_I4, TMEM_PALETTE, 0, NULL);
+    rdpq_load_tlut_raw(TILE7, 0, colors);
+}
+
+static void tmem_run(void) {
+    uint8_t *src = malloc_uncached_aligned(64, SRC_PITCH_BYTES * SRC_ROWS);
+    for (int i = 0; i < SRC_PITCH_BYTES * SRC_ROWS; i++) {
+        src[i] = i;
+    }
+
+    // Fixed cost of a batch (sync + queue flush) with no loads in it
+    rdp_counters_reset();
+    uint32_t baseline = rdp_busy_cycles();
+
+    for (int f = 0; f < TMEM_FORMAT_COUNT; f++) {
+        tex_format_t fmt = tmem_formats[f].fmt;
+
+        for (int s = 0; s < TMEM_SIZE_COUNT; s++) {
+            int w = tmem_sizes[s].w;
+            int h = tmem_sizes[s].h;
+
+            for (int m = 0; m < LOAD_METHOD_COUNT; m++) {
+                load_rate[f][s][m] = 0.0f;
+                if (!fits_tmem(fmt, w, h)) {
+                    continue;
+                }
+
+                rdp_counters_reset();
+                for (int i = 0; i < TMEM_REPEAT; i++) {
+                    issue_load(src, fmt, w, h, (LoadMethod)m);
+                }
+                uint32_t cycles = rdp_busy_cycles();
+
+                if (cycles > baseline) {
+                    uint32_t bytes = texture_bytes(fmt, w, h) * TMEM_REPEAT;
+                    load_rate[f][s][m] = (float)bytes / (float)(cycles - baseline);
+                }
+            }
+        }
+    }
+
+    for (int t = 0; t < TLUT_SIZE_COUNT; t++) {
+        rdp_counters_reset();
+        for (int i = 0; i < TMEM_REPEAT; i++) {
+            issue_tlut(src, tlut_sizes[t]);
+        }
+        uint32_t cycles = rdp_busy_cycles();
+
+        tlut_rate[t] = 0.0f;
+        if (cycles > baseline) {
+            tlut_rate[t] = (float)(tlut_sizes[t] * 2 * TMEM_REPEAT) / (float)(cycles - baseline);
+        }
+    }
+
+    free_uncached(src);
+    has_results = 1;
+}
+
+static void tmem_draw(display_context_t disp, int y, int page) {
+    const TmemFormat *format = &tmem_formats[page];
+    char buffer[64];
+
+    if (!has_results) {
+        ui_draw_text(disp, 20, y, "Press A to run");
+        return;
+    }
+
+    snprintf(buffer, sizeof(buffer), "%s  (bytes / RDP cycle)", format->name);
+    ui_draw_text(disp, 15, y, buffer);
+    y += UI_LINE_HEIGHT + 2;
+
+    // "+1" columns start the load one texel past an 8-byte boundary
+    ui_draw_text(disp, 20, y, "Size     Block  +1   Tile   +1");
+    y += UI_LINE_HEIGHT;
+
+    for (int s = 0; s < TMEM_SIZE_COUNT; s++) {
+        const float *r = load_rate[page][s];
+
+        if (!fits_tmem(format->fmt, tmem_sizes[s].w, tmem_sizes[s].h)) {
+            continue;
+        }
+
+        char size[16];
+        snprintf(size, sizeof(size), "%dx%d", tmem_sizes[s].w, tmem_sizes[s].h);
+        snprintf(buffer, sizeof(buffer), "%-7s  %5.2f %5.2f  %5.2f %5.2f",
+                 size, r[LOAD_BLOCK_ALIGNED], r[LOAD_BLOCK_UNALIGNED],
+                 r[LOAD_TILE_ALIGNED], r[LOAD_TILE_UNALIGNED]);
+        ui_draw_text(disp, 20, y, buffer);
+        y += UI_LINE_HEIGHT;
+    }
+
+    if (is_ci_format(format->fmt)) {
+        y += 3;
+        ui_draw_text(disp, 15, y, "Palette (LOAD_TLUT)");
+        y += UI_LINE_HEIGHT + 2;
+
+        for (int t = 0; t < TLUT_SIZE_COUNT; t++) {
+            snprintf(buffer, sizeof(buffer), "%u colors", tlut_sizes[t]);
+            char value[16];
+            snprintf(value, sizeof(value), "%.2f", tlut_rate[t]);
+            draw_label_value(disp, 20, y, buffer, value);
+            y += UI_LINE_HEIGHT;
+        }
+    }
+}
+
+static float tmem_score(void) {
+    return load_rate[1][1][LOAD_BLOCK_ALIGNED];     // RGBA16 32x32
+}
+
+const Benchmark bench_tmem = {
+    .name = "TMEM Upload",
+    .short_name = "TMEM",
+    .pages = TMEM_FORMAT_COUNT,
+    .run = tmem_run,
+    .draw = tmem_draw,
+    .score_name = "RGBA16 32x32 Block",
+    .score_unit = "B/cyc",
+    .score = tmem_score,
+};
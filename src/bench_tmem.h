@@ -0,0 +1,9 @@
+#ifndef BENCH_TMEM_H
+#define BENCH_TMEM_H
+
+#include "bench.h"
+
+// TMEM texture upload bandwidth: LOAD_BLOCK vs LOAD_TILE vs LOAD_TLUT
+extern const Benchmark bench_tmem;
+
+#endif /* BENCH_TMEM_H */
@@ -0,0 +1,245 @@
+#include <libdragon.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdint.h>
+
+#include "bench_tri.h"
+#include "hw.h"
+#include "ui.h"
+
+// Offscreen target, so the benchmark never touches the visible framebuffer
+#define TRI_TARGET_W     320
+#define TRI_TARGET_H     240
+
+// Pixels drawn per batch; small triangles are capped by TRI_MAX_BATCH instead,
+// which also bounds the recorded block (about 100 bytes per triangle)
+#define TRI_PIXEL_BUDGET (2 * 1024 * 1024)
+#define TRI_MIN_BATCH    16
+#define TRI_MAX_BATCH    2048
+
+// Vertex layout shared by every configuration: X Y Z R G B A S T W
+#define VTX_POS    0
+#define VTX_Z      2
+#define VTX_SHADE  3
+#define VTX_TEX    7
+#define VTX_FLOATS 10
+
+typedef enum {
+    TRI_FLAT = 0,
+    TRI_SHADED,
+    TRI_TEXTURED,
+    TRI_ZBUFFERED,
+    TRI_CONFIG_COUNT
+} TriConfig;
+
+static const char *tri_config_names[TRI_CONFIG_COUNT] = {
+    "Flat",
+    "Shaded",
+    "Textured",
+    "Z-Buffered"
+};
+
+static const rdpq_trifmt_t tri_formats[TRI_CONFIG_COUNT] = {
+    [TRI_FLAT]      = { .pos_offset = VTX_POS, .shade_offset = -1, .tex_offset = -1, .z_offset = -1 },
+    [TRI_SHADED]    = { .pos_offset = VTX_POS, .shade_offset = VTX_SHADE, .tex_offset = -1, .z_offset = -1 },
+    [TRI_TEXTURED]  = { .pos_offset = VTX_POS, .shade_offset = -1, .tex_offset = VTX_TEX, .tex_tile = TILE0, .z_offset = -1 },
+    [TRI_ZBUFFERED] = { .pos_offset = VTX_POS, .shade_offset = -1, .tex_offset = -1, .z_offset = VTX_Z },
+};
+
+// Triangle areas in pixels; the last entry covers the whole target
+static const uint32_t tri_areas[] = {
+    1, 4, 16, 64, 256, 1024, 4096, 16384, TRI_TARGET_W * TRI_TARGET_H
+};
+#define TRI_AREA_COUNT (int)(sizeof(tri_areas) / sizeof(tri_areas[0]))
+
+typedef struct {
+    uint32_t tris_per_sec[TRI_AREA_COUNT];
+    float setup_ns;         // Time per triangle when setup-bound
+    float fill_ns_per_px;   // Marginal time per pixel when fill-bound
+    uint32_t crossover_px;  // Area where fill time equals setup time
+} TriResult;
+
+static TriResult tri_results[TRI_CONFIG_COUNT];
+static int has_results = 0;
+
+static void set_config_mode(TriConfig config, surface_t *texture) {
+    rdpq_set_mode_standard();
+
+    switch (config) {
+        case TRI_FLAT:
+            rdpq_mode_combiner(RDPQ_COMBINER_FLAT);
+            rdpq_set_prim_color(RGBA32(0x4A, 0x4A, 0x6A, 0xFF));
+            break;
+        case TRI_SHADED:
+            rdpq_mode_combiner(RDPQ_COMBINER_SHADE);
+            break;
+        case TRI_TEXTURED:
+            rdpq_mode_combiner(RDPQ_COMBINER_TEX);
+            rdpq_tex_upload(TILE0, texture, NULL);
+            break;
+        case TRI_ZBUFFERED:
+            rdpq_mode_combiner(RDPQ_COMBINER_FLAT);
+            rdpq_set_prim_color(RGBA32(0x4A, 0x4A, 0x6A, 0xFF));
+            rdpq_mode_zbuf(true, true);
+            break;
+        case TRI_CONFIG_COUNT:
+            break;
+    }
+}
+
+static void set_vertex(float *v, float x, float y, float s, float t) {
+    v[VTX_POS + 0] = x;
+    v[VTX_POS + 1] = y;
+    v[VTX_Z] = 0.5f;
+    v[VTX_SHADE + 0] = 1.0f;
+    v[VTX_SHADE + 1] = 0.5f;
+    v[VTX_SHADE + 2] = 0.25f;
+    v[VTX_SHADE + 3] = 1.0f;
+    v[VTX_TEX + 0] = s;
+    v[VTX_TEX + 1] = t;
+    v[VTX_TEX + 2] = 1.0f;
+}
+
+// Record a batch of right triangles of the given area into a block, then
+// return the wall time in COUNT ticks from running the block until the RDP
+// has finished drawing them. Building the commands (vertex math, edge
+// setup on the CPU) happens before the window, so small triangles measure
+// RDP setup rather than CPU submission.
+static uint32_t time_batch(TriConfig config, uint32_t area, int count) {
+    float v1[VTX_FLOATS], v2[VTX_FLOATS], v3[VTX_FLOATS];
+    int full_screen = (area >= TRI_TARGET_W * TRI_TARGET_H);
+    float leg = full_screen ? 0.0f : sqrtf(2.0f * area);
+
+    rspq_block_begin();
+    for (int i = 0; i < count; i++) {
+        if (full_screen) {
+            // Twice the target size: the scissor clips it to exactly the screen
+            set_vertex(v1, 0, 0, 0, 0);
+            set_vertex(v2, TRI_TARGET_W * 2, 0, 64, 0);
+            set_vertex(v3, 0, TRI_TARGET_H * 2, 0, 64);
+        } else {
+            // Spread triangles over the target to avoid a single hot spot
+            float x = (float)((i * 37) % (TRI_TARGET_W - (int)leg - 1));
+            float y = (float)((i * 23) % (TRI_TARGET_H - (int)leg - 1));
+            set_vertex(v1, x, y, 0, 0);
+            set_vertex(v2, x + leg, y, leg, 0);
+            set_vertex(v3, x, y + leg, 0, leg);
+        }
+        rdpq_triangle(&tri_formats[config], v1, v2, v3);
+    }
+    rspq_block_t *block = rspq_block_end();
+
+    rspq_wait();
+    uint32_t count_start = read_c0_count();
+    rspq_block_run(block);
+    rspq_wait();
+    uint32_t ticks = read_c0_count() - count_start;
+
+    rspq_block_free(block);
+    return ticks;
+}
+
+static void tri_run(void) {
+    surface_t color = surface_alloc(FMT_RGBA16, TRI_TARGET_W, TRI_TARGET_H);
+    surface_t zbuf = surface_alloc(FMT_RGBA16, TRI_TARGET_W, TRI_TARGET_H);
+    surface_t texture = surface_alloc(FMT_RGBA16, 32, 32);
+
+    uint16_t *texels = texture.buffer;
+    for (int i = 0; i < 32 * 32; i++) {
+        texels[i] = (i & 1) ? 0xFFFF : 0x4211;
+    }
+    data_cache_hit_writeback(texture.buffer, 32 * 32 * 2);
+
+    rdpq_attach_clear(&color, &zbuf);
+
+    for (int c = 0; c < TRI_CONFIG_COUNT; c++) {
+        TriResult *r = &tri_results[c];
+        float ns_per_tri[TRI_AREA_COUNT];
+
+        set_config_mode((TriConfig)c, &texture);
+
+        for (int a = 0; a < TRI_AREA_COUNT; a++) {
+            int count = TRI_PIXEL_BUDGET / tri_areas[a];
+            if (count < TRI_MIN_BATCH) count = TRI_MIN_BATCH;
+            if (count > TRI_MAX_BATCH) count = TRI_MAX_BATCH;
+
+            uint32_t ticks = time_batch((TriConfig)c, tri_areas[a], count);
+            if (ticks == 0) ticks = 1;
+
+            float seconds = (float)ticks / (float)TICKS_PER_SECOND;
+            r->tris_per_sec[a] = (uint32_t)(count / seconds);
+            ns_per_tri[a] = seconds * 1e9f / count;
+        }
+
+        // Model: time(area) = setup + area * fill.
+        // Setup comes from the smallest triangles, fill from the largest two.
+        int hi = TRI_AREA_COUNT - 1;
+        int lo = TRI_AREA_COUNT - 2;
+        r->setup_ns = ns_per_tri[0];
+        r->fill_ns_per_px = (ns_per_tri[hi] - ns_per_tri[lo]) /
+                            (float)(tri_areas[hi] - tri_areas[lo]);
+        r->crossover_px = 0;
+        if (r->fill_ns_per_px > 0) {
+            r->crossover_px = (uint32_t)(r->setup_ns / r->fill_ns_per_px);
+        }
+    }
+
+    rdpq_detach_wait();
+    surface_free(&texture);
+    surface_free(&zbuf);
+    surface_free(&color);
+    has_results = 1;
+}
+
+static void tri_draw(display_context_t disp, int y, int page) {
+    const TriResult *r = &tri_results[page];
+    char buffer[64];
+
+    if (!has_results) {
+        ui_draw_text(disp, 20, y, "Press A to run");
+        return;
+    }
+
+    snprintf(buffer, sizeof(buffer), "%s triangles", tri_config_names[page]);
+    ui_draw_text(disp, 15, y, buffer);
+    y += UI_LINE_HEIGHT + 2;
+
+    ui_draw_text(disp, 20, y, "Area px      Tris/s");
+    y += UI_LINE_HEIGHT;
+
+    for (int a = 0; a < TRI_AREA_COUNT; a++) {
+        snprintf(buffer, sizeof(buffer), "%-8lu  %10lu",
+                 (unsigned long)tri_areas[a], (unsigned long)r->tris_per_sec[a]);
+        ui_draw_text(disp, 20, y, buffer);
+        y += UI_LINE_HEIGHT;
+    }
+
+    y += 3;
+
+    snprintf(buffer, sizeof(buffer), "%.0f ns/tri", r->setup_ns);
+    draw_label_value(disp, 20, y, "Setup Cost", buffer);
+    y += UI_LINE_HEIGHT;
+
+    snprintf(buffer, sizeof(buffer), "%.2f ns/px", r->fill_ns_per_px);
+    draw_label_value(disp, 20, y, "Fill Cost", buffer);
+    y += UI_LINE_HEIGHT;
+
+    snprintf(buffer, sizeof(buffer), "~%lu px", (unsigned long)r->crossover_px);
+    draw_label_value(disp, 20, y, "Setup/Fill Crossover", buffer);
+    y += UI_LINE_HEIGHT;
+}
+
+static float tri_score(void) {
+    return tri_results[TRI_FLAT].tris_per_sec[0] / 1000.0f;    // Setup-bound
+}
+
+const Benchmark bench_tri = {
+    .name = "Triangle Throughput",
+    .short_name = "Tri",
+    .pages = TRI_CONFIG_COUNT,
+    .run = tri_run,
+    .draw = tri_draw,
+    .score_name = "Flat 1 px",
+    .score_unit = "K tris/s",
+    .score = tri_score,
+};
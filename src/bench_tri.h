@@ -0,0 +1,9 @@
+#ifndef BENCH_TRI_H
+#define BENCH_TRI_H
+
+#include "bench.h"
+
+// RDP triangle setup vs fill throughput across primitive sizes
+extern const Benchmark bench_tri;
+
+#endif /* BENCH_TRI_H */
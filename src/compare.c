@@ -0,0 +1,238 @@
+#include <libdragon.h>
+#include <stdio.h>
+#include <stdint.h>
+
+#include "compare.h"
+#include "settings.h"
+#include "stats.h"
+#include "ui.h"
+
+typedef enum {
+    ROW_SETTING = 0,
+    ROW_VALUE_A,
+    ROW_VALUE_B,
+    ROW_BENCHMARKS,
+    ROW_RUN,
+    ROW_COUNT
+} Row;
+
+typedef enum {
+    STATE_IDLE = 0,
+    STATE_RUNNING,
+    STATE_DONE,
+    STATE_STOPPED
+} State;
+
+// Configuration of each run within an ABBA block
+static const uint8_t block_order[4] = { 0, 1, 1, 0 };
+
+static const Benchmark* const *benchmarks;
+static int bench_count = 0;
+
+static int selected = 0;
+static int setting = 0;
+static int values[2] = { 0, 1 };
+static int bench_set = 0;           // A benchmark index, or bench_count for all
+
+static State state = STATE_IDLE;
+static int step = 0;
+static int steps = 0;
+static int applied = -1;            // Configuration currently set, -1 before the first
+static int settle = 0;
+static int restore = 0;             // Value of the setting before the comparison
+
+static StatsRunning scores[COMPARE_BENCH_MAX][2];
+
+void compare_init(const Benchmark* const *list, int count) {
+    benchmarks = list;
+    bench_count = (count < COMPARE_BENCH_MAX) ? count : COMPARE_BENCH_MAX;
+    bench_set = bench_count;
+    values[0] = settings_get(setting);
+    values[1] = (values[0] + 1) % settings_value_count(setting);
+}
+
+static int set_first(void) {
+    return (bench_set == bench_count) ? 0 : bench_set;
+}
+
+static int set_size(void) {
+    return (bench_set == bench_count) ? bench_count : 1;
+}
+
+static void start(void) {
+    for (int b = 0; b < bench_count; b++) {
+        stats_running_init(&scores[b][0]);
+        stats_running_init(&scores[b][1]);
+    }
+    restore = settings_get(setting);
+    step = 0;
+    steps = COMPARE_ROUNDS * 4 * set_size();
+    applied = -1;
+    settle = 0;
+    state = STATE_RUNNING;
+}
+
+static void finish(State end) {
+    settings_set(setting, restore);
+    state = end;
+}
+
+void compare_input(const struct controller_data *keys) {
+    if (keys->c[0].up) {
+        selected = (selected - 1 + ROW_COUNT) % ROW_COUNT;
+        ui_invalidate();
+    }
+    if (keys->c[0].down) {
+        selected = (selected + 1) % ROW_COUNT;
+        ui_invalidate();
+    }
+    if (!keys->c[0].A) {
+        return;
+    }
+
+    // Only stopping is possible while a comparison runs
+    if (state == STATE_RUNNING) {
+        if (selected == ROW_RUN) {
+            finish(STATE_STOPPED);
+        }
+        return;
+    }
+
+    switch (selected) {
+        case ROW_SETTING:
+            setting = (setting + 1) % settings_count();
+            values[0] = settings_get(setting);
+            values[1] = (values[0] + 1) % settings_value_count(setting);
+            state = STATE_IDLE;
+            break;
+        case ROW_VALUE_A:
+        case ROW_VALUE_B:
+            values[selected - ROW_VALUE_A] = (values[selected - ROW_VALUE_A] + 1) %
+                                             settings_value_count(setting);
+            break;
+        case ROW_BENCHMARKS:
+            bench_set = (bench_set + 1) % (bench_count + 1);
+            state = STATE_IDLE;
+            break;
+        case ROW_RUN:
+            if (values[0] != values[1]) {
+                start();
+            }
+            break;
+    }
+    ui_invalidate();
+}
+
+int compare_step(void) {
+    if (state != STATE_RUNNING) {
+        return 0;
+    }
+    if (settle > 0) {
+        settle--;
+        return 0;
+    }
+
+    int n = set_size();
+    int config = block_order[(step / n) % 4];
+    if (config != applied) {
+        settings_set(setting, values[config]);
+        applied = config;
+        settle = COMPARE_SETTLE_FRAMES;
+        return 0;
+    }
+
+    int b = set_first() + step % n;
+    benchmarks[b]->run();
+    stats_running_add(&scores[b][config], benchmarks[b]->score());
+
+    if (++step == steps) {
+        finish(STATE_DONE);
+    }
+    return 1;
+}
+
+int compare_running(void) {
+    return state == STATE_RUNNING;
+}
+
+static const char* run_text(char *buffer, size_t size) {
+    switch (state) {
+        case STATE_RUNNING:
+            snprintf(buffer, size, "Run %d/%d, A: Stop", step + 1, steps);
+            return buffer;
+        case STATE_DONE:
+            return "Done, A: Again";
+        case STATE_STOPPED:
+            snprintf(buffer, size, "Stopped at %d/%d", step, steps);
+            return buffer;
+        default:
+            return (values[0] == values[1]) ? "A and B are equal" : "A: Start";
+    }
+}
+
+// Score of B against A with the 95% interval, both in percent of A,
+// colored when the difference is significant
+static void draw_result(display_context_t disp, int y, int b) {
+    const Benchmark *bench = benchmarks[b];
+    const StatsRunning *a = &scores[b][0];
+    char buffer[64];
+
+    if (a->n < 2 || scores[b][1].n < 2 || a->mean == 0.0) {
+        snprintf(buffer, sizeof(buffer), "%-7s%30s", bench->short_name, "-");
+        ui_draw_field(disp, 20, y, buffer);
+        return;
+    }
+
+    StatsWelch w = stats_welch(a, &scores[b][1]);
+    float diff = (float)(w.diff * 100.0 / a->mean);
+    float ci = (float)(w.ci95 * 100.0 / a->mean);
+    int better = bench->lower_is_better ? diff < 0.0f : diff > 0.0f;
+
+    snprintf(buffer, sizeof(buffer), "%-7s%8.2f%8.2f%+7.1f%%%6.1f", bench->short_name,
+             a->mean, scores[b][1].mean, diff, ci);
+    ui_set_color(!w.significant ? UI_COLOR_TEXT : better ? UI_COLOR_GREEN : UI_COLOR_RED,
+                 UI_COLOR_BACKGROUND);
+    ui_draw_field(disp, 20, y, buffer);
+    ui_set_color(UI_COLOR_TEXT, UI_COLOR_BACKGROUND);
+}
+
+void compare_draw(display_context_t disp, int y) {
+    int line_height = UI_LINE_HEIGHT;
+    char buffer[64];
+
+    ui_draw_text(disp, 15, y, "A/B Compare");
+    y += line_height + 2;
+
+    const char *row_values[ROW_COUNT] = {
+        [ROW_SETTING]    = settings_label(setting),
+        [ROW_VALUE_A]    = settings_value_name(setting, values[0]),
+        [ROW_VALUE_B]    = settings_value_name(setting, values[1]),
+        [ROW_BENCHMARKS] = (bench_set == bench_count) ? "All" : benchmarks[bench_set]->name,
+        [ROW_RUN]        = run_text(buffer, sizeof(buffer)),
+    };
+    static const char* const row_labels[ROW_COUNT] = {
+        "Setting", "Config A", "Config B", "Benchmarks", "Run",
+    };
+
+    for (int i = 0; i < ROW_COUNT; i++) {
+        if (i == selected) {
+            ui_draw_box(disp, 16, y - 2, 288, line_height, UI_COLOR_HIGHLIGHT);
+            ui_set_color(UI_COLOR_TEXT, UI_COLOR_HIGHLIGHT);
+        }
+        draw_label_value(disp, 20, y, row_labels[i], row_values[i]);
+        ui_set_color(UI_COLOR_TEXT, UI_COLOR_BACKGROUND);
+        y += line_height;
+    }
+    y += 3;
+
+    ui_draw_text(disp, 15, y, "Mean Scores, B vs A (% of A)");
+    y += line_height + 2;
+    snprintf(buffer, sizeof(buffer), "%-7s%8s%8s%8s%6s", "Bench", "A", "B", "Diff", "+/-95");
+    ui_draw_text(disp, 20, y, buffer);
+    y += line_height;
+
+    for (int i = 0; i < set_size(); i++) {
+        draw_result(disp, y, set_first() + i);
+        y += line_height;
+    }
+}
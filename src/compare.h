@@ -0,0 +1,29 @@
+#ifndef COMPARE_H
+#define COMPARE_H
+
+#include <libdragon.h>
+
+#include "bench.h"
+
+// A/B comparison: runs benchmarks under two values of one Setup option and
+// reports the change in their headline scores. The configurations take
+// turns in ABBA blocks, so a linear drift (warm-up, temperature) adds the
+// same amount to both. One benchmark runs per frame, and after every switch
+// a few frames pass so that display modes and timers settle.
+#define COMPARE_ROUNDS         4    // ABBA blocks, 2 runs per configuration each
+#define COMPARE_SETTLE_FRAMES  3
+#define COMPARE_BENCH_MAX      8
+
+void compare_init(const Benchmark* const *benchmarks, int count);
+
+// Setup tab, A/B page: D-Up/D-Down selects a row, A changes it or
+// starts/stops the comparison
+void compare_input(const struct controller_data *keys);
+
+// Advance a running comparison; returns 1 when a benchmark ran this frame
+int compare_step(void);
+int compare_running(void);
+
+void compare_draw(display_context_t disp, int y);
+
+#endif /* COMPARE_H */
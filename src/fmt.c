@@ -0,0 +1,118 @@
+#include "fmt.h"
+
+// Largest supported scale: 10^4 keeps a float in range of int32_t
+#define FMT_MAX_DECIMALS 4
+
+static const int32_t powers_of_ten[FMT_MAX_DECIMALS + 1] = { 1, 10, 100, 1000, 10000 };
+
+static const char hex_digits[16] = "0123456789ABCDEF";
+
+char* fmt_str(char *dst, const char *s) {
+    while (*s) {
+        *dst++ = *s++;
+    }
+    *dst = '\0';
+    return dst;
+}
+
+char* fmt_pad(char *dst, const char *s, int width) {
+    char *start = dst;
+    dst = fmt_str(dst, s);
+    while (dst - start < width) {
+        *dst++ = ' ';
+    }
+    *dst = '\0';
+    return dst;
+}
+
+char* fmt_rjust(char *dst, const char *s, int width) {
+    int len = 0;
+    while (s[len]) {
+        len++;
+    }
+    while (len < width--) {
+        *dst++ = ' ';
+    }
+    return fmt_str(dst, s);
+}
+
+char* fmt_u32(char *dst, uint32_t value) {
+    char digits[10];
+    int n = 0;
+
+    // Division by a constant compiles to a multiply on the VR4300
+    do {
+        digits[n++] = '0' + value % 10;
+        value /= 10;
+    } while (value);
+
+    while (n) {
+        *dst++ = digits[--n];
+    }
+    *dst = '\0';
+    return dst;
+}
+
+char* fmt_fixed(char *dst, int32_t value, int decimals) {
+    uint32_t magnitude;
+
+    if (decimals < 0) decimals = 0;
+    if (decimals > FMT_MAX_DECIMALS) decimals = FMT_MAX_DECIMALS;
+
+    if (value < 0) {
+        *dst++ = '-';
+        magnitude = -(uint32_t)value;
+    } else {
+        magnitude = value;
+    }
+
+    dst = fmt_u32(dst, magnitude / powers_of_ten[decimals]);
+    if (decimals == 0) {
+        return dst;
+    }
+
+    *dst++ = '.';
+    uint32_t fraction = magnitude % powers_of_ten[decimals];
+    for (int i = decimals - 1; i >= 0; i--) {
+        dst[i] = '0' + fraction % 10;
+        fraction /= 10;
+    }
+    dst += decimals;
+    *dst = '\0';
+    return dst;
+}
+
+char* fmt_float(char *dst, float value, int decimals) {
+    if (decimals < 0) decimals = 0;
+    if (decimals > FMT_MAX_DECIMALS) decimals = FMT_MAX_DECIMALS;
+
+    // Round half away from zero; only exact binary halves can differ from printf
+    float scaled = value * powers_of_ten[decimals];
+    int32_t fixed = (int32_t)(scaled < 0 ? scaled - 0.5f : scaled + 0.5f);
+
+    // Keep the sign of small negative values that round to zero
+    if (fixed == 0 && scaled < 0) {
+        *dst++ = '-';
+    }
+    return fmt_fixed(dst, fixed, decimals);
+}
+
+char* fmt_hex32(char *dst, uint32_t value) {
+    *dst++ = '0';
+    *dst++ = 'x';
+    for (int shift = 28; shift >= 0; shift -= 4) {
+        *dst++ = hex_digits[(value >> shift) & 0xF];
+    }
+    *dst = '\0';
+    return dst;
+}
+
+char* fmt_mhz(char *dst, float mhz) {
+    dst = fmt_float(dst, mhz, 2);
+    return fmt_str(dst, " MHz");
+}
+
+char* fmt_mbps(char *dst, uint32_t mbps) {
+    dst = fmt_u32(dst, mbps);
+    return fmt_str(dst, " MB/s");
+}
@@ -0,0 +1,22 @@
+#ifndef FMT_H
+#define FMT_H
+
+#include <stdint.h>
+
+// Allocation-free formatting of UI values, without the newlib printf path.
+// Every function writes a NUL-terminated string at dst and returns a pointer
+// to that NUL, so calls can be chained to build one line. The caller
+// provides the space: at most FMT_MAX bytes per call, excluding strings.
+#define FMT_MAX 24
+
+char* fmt_str(char *dst, const char *s);
+char* fmt_pad(char *dst, const char *s, int width);      // "%-*s"
+char* fmt_rjust(char *dst, const char *s, int width);    // "%*s"
+char* fmt_u32(char *dst, uint32_t value);                // "%lu"
+char* fmt_fixed(char *dst, int32_t value, int decimals); // value / 10^decimals
+char* fmt_float(char *dst, float value, int decimals);   // "%.*f"
+char* fmt_hex32(char *dst, uint32_t value);              // "0x%08lX"
+char* fmt_mhz(char *dst, float mhz);                     // "%.2f MHz"
+char* fmt_mbps(char *dst, uint32_t mbps);                // "%lu MB/s"
+
+#endif /* FMT_H */
@@ -0,0 +1,181 @@
+#include <libdragon.h>
+#include <math.h>
+#include <stdint.h>
+
+#include "graph.h"
+#include "fmt.h"
+#include "ui.h"
+
+// One column per frame sample, so a graph spans the whole frame tier
+#define GRAPH_WIDTH  HISTORY_FRAME_SLOTS
+#define GRAPH_HEIGHT 22
+#define GRAPH_X      ((320 - GRAPH_WIDTH) / 2)
+#define GRAPH_GAP    4
+
+typedef struct {
+    surface_t surface;      // RGBA16 ring of columns
+    int head;               // Column the next sample goes to
+    uint32_t consumed;      // Frame samples drawn so far (history_total)
+    float lo, hi;           // Vertical range; only ever widened
+    int ranged;
+    int last_row;           // Row of the previous sample, to join the line
+} Graph;
+
+#define GRAPH_COLOR_HIST(id, color) [HISTORY_##id] = color,
+#define GRAPH_COLOR_NOHIST(id, color)
+
+static const UiColor graph_colors[HISTORY_METRIC_COUNT] = {
+#define GRAPH_COLOR(id, type, field, name, unit, sample, period, format, stats, history, color, ...) \
+    GRAPH_COLOR_##history(id, color)
+    METRIC_TABLE(GRAPH_COLOR)
+#undef GRAPH_COLOR
+};
+
+static Graph graphs[HISTORY_METRIC_COUNT];
+
+void graph_init(void) {
+    for (int m = 0; m < HISTORY_METRIC_COUNT; m++) {
+        Graph *g = &graphs[m];
+        g->surface = surface_alloc(FMT_RGBA16, GRAPH_WIDTH, GRAPH_HEIGHT);
+        // Columns are written uncached; drop any lines the allocator left dirty
+        data_cache_hit_writeback_invalidate(g->surface.buffer, g->surface.stride * GRAPH_HEIGHT);
+        g->last_row = -1;
+    }
+}
+
+static int value_row(const Graph *g, float v) {
+    int row = (GRAPH_HEIGHT - 1) - (int)((v - g->lo) * (GRAPH_HEIGHT - 1) / (g->hi - g->lo) + 0.5f);
+    if (row < 0) row = 0;
+    if (row > GRAPH_HEIGHT - 1) row = GRAPH_HEIGHT - 1;
+    return row;
+}
+
+// Widen the range to include v; returns 1 when the existing columns no
+// longer match the scale
+static int widen_range(Graph *g, float v) {
+    if (!g->ranged) {
+        float pad = fabsf(v) * 0.05f;
+        if (pad < 1.0f) pad = 1.0f;
+        g->lo = v - pad;
+        g->hi = v + pad;
+        g->ranged = 1;
+        return 1;
+    }
+
+    float span = g->hi - g->lo;
+    if (v < g->lo) {
+        g->lo = v - span * 0.25f;
+        return 1;
+    }
+    if (v > g->hi) {
+        g->hi = v + span * 0.25f;
+        return 1;
+    }
+    return 0;
+}
+
+// Rewrite one column: a vertical span joining the previous sample to this
+// one, background elsewhere. 22 uncached stores, no cache maintenance.
+static void push_sample(Graph *g, float v, uint16_t fg, uint16_t bg) {
+    uint16_t *px = (uint16_t *)UncachedAddr(g->surface.buffer) + g->head;
+    int stride = g->surface.stride / 2;
+    int row = value_row(g, v);
+    int top = row, bottom = row;
+
+    if (g->last_row >= 0) {
+        if (g->last_row < top) top = g->last_row;
+        if (g->last_row > bottom) bottom = g->last_row;
+    }
+
+    for (int y = 0; y < GRAPH_HEIGHT; y++) {
+        px[y * stride] = (y >= top && y <= bottom) ? fg : bg;
+    }
+
+    g->last_row = row;
+    g->head = (g->head + 1) % GRAPH_WIDTH;
+}
+
+static void rebuild(Graph *g, const History *h, HistoryMetric metric, uint16_t fg, uint16_t bg) {
+    int count = history_count(h, HISTORY_FRAME);
+
+    for (int age = count - 1; age >= 0; age--) {
+        widen_range(g, history_get(h, HISTORY_FRAME, metric, age)->mean);
+    }
+
+    // Empty columns first, so the newest sample ends up at the right edge
+    g->head = 0;
+    g->last_row = -1;
+    for (int i = count; i < GRAPH_WIDTH; i++) {
+        uint16_t *px = (uint16_t *)UncachedAddr(g->surface.buffer) + g->head;
+        for (int y = 0; y < GRAPH_HEIGHT; y++) {
+            px[y * (g->surface.stride / 2)] = bg;
+        }
+        g->head = (g->head + 1) % GRAPH_WIDTH;
+    }
+    for (int age = count - 1; age >= 0; age--) {
+        push_sample(g, history_get(h, HISTORY_FRAME, metric, age)->mean, fg, bg);
+    }
+}
+
+// Draw the samples recorded since the last update, one column each
+static void graph_update(Graph *g, const History *h, HistoryMetric metric) {
+    uint16_t fg = color_to_packed16(ui_palette(graph_colors[metric]));
+    uint16_t bg = color_to_packed16(ui_palette(UI_COLOR_BAR));
+    uint32_t total = history_total(h, HISTORY_FRAME);
+    uint32_t fresh = total - g->consumed;
+    int full = !g->ranged || fresh >= GRAPH_WIDTH;
+
+    g->consumed = total;
+    if (fresh == 0) {
+        return;
+    }
+
+    for (int age = (int)fresh - 1; age >= 0 && !full; age--) {
+        full = widen_range(g, history_get(h, HISTORY_FRAME, metric, age)->mean);
+    }
+
+    if (full) {
+        rebuild(g, h, metric, fg, bg);
+        return;
+    }
+    for (int age = (int)fresh - 1; age >= 0; age--) {
+        push_sample(g, history_get(h, HISTORY_FRAME, metric, age)->mean, fg, bg);
+    }
+}
+
+void graph_draw_page(display_context_t disp, int y, const History *history) {
+    char buffer[64];
+
+    ui_draw_text(disp, 15, y, "Graphs (1 column per frame)");
+    y += UI_LINE_HEIGHT + 2;
+
+    for (int m = 0; m < HISTORY_METRIC_COUNT; m++) {
+        Graph *g = &graphs[m];
+        const HistorySample *now = history_get(history, HISTORY_FRAME, (HistoryMetric)m, 0);
+        if (!now) {
+            return;
+        }
+
+        graph_update(g, history, (HistoryMetric)m);
+
+        char value[FMT_MAX];
+        char *p = fmt_str(fmt_pad(buffer, history_metric_names[m], 10), " ");
+        fmt_float(value, now->mean, 2);
+        p = fmt_str(fmt_rjust(p, value, 8), "   ");
+        p = fmt_str(fmt_float(p, g->lo, 1), " - ");
+        fmt_float(p, g->hi, 1);
+        ui_draw_text(disp, GRAPH_X, y, buffer);
+        y += UI_LINE_HEIGHT;
+
+        // Oldest column is at head: show [head, end) then [0, head). With
+        // triple buffering the RDP can still be blitting the previous frame
+        // while this one rewrites the oldest column; at worst the left edge
+        // shows the new sample one frame early.
+        int split = GRAPH_WIDTH - g->head;
+        ui_blit(disp, &g->surface, GRAPH_X, y, g->head, split);
+        if (g->head > 0) {
+            ui_blit(disp, &g->surface, GRAPH_X + split, y, 0, g->head);
+        }
+        y += GRAPH_HEIGHT + GRAPH_GAP;
+    }
+}
@@ -0,0 +1,16 @@
+#ifndef GRAPH_H
+#define GRAPH_H
+
+#include <libdragon.h>
+
+#include "history.h"
+
+// Sparklines of the frame-resolution history, one per metric. Each graph
+// is a circular buffer of columns: a new sample writes one column and the
+// graph is shown with two blits, so nothing scrolls in memory.
+void graph_init(void);
+
+// Live tab page: one labeled sparkline per history metric
+void graph_draw_page(display_context_t disp, int y, const History *history);
+
+#endif /* GRAPH_H */
@@ -0,0 +1,138 @@
+#include <stdint.h>
+#include <string.h>
+
+#include "history.h"
+
+#define SECOND_MS        1000
+#define SECONDS_PER_MIN  60
+
+#define HISTORY_NAME_HIST(id, name) [HISTORY_##id] = name,
+#define HISTORY_NAME_NOHIST(id, name)
+
+const char* history_metric_names[HISTORY_METRIC_COUNT] = {
+#define HISTORY_NAME(id, type, field, name, unit, sample, period, format, stats, history, ...) \
+    HISTORY_NAME_##history(id, name)
+    METRIC_TABLE(HISTORY_NAME)
+#undef HISTORY_NAME
+};
+
+const char* history_tier_names[HISTORY_TIER_COUNT] = {
+    "Frame",
+    "Second",
+    "Minute"
+};
+
+static const int tier_capacity[HISTORY_TIER_COUNT] = {
+    HISTORY_FRAME_SLOTS,
+    HISTORY_SECOND_SLOTS,
+    HISTORY_MINUTE_SLOTS
+};
+
+static HistorySample* tier_slots(History *h, HistoryTier tier, int metric) {
+    switch (tier) {
+        case HISTORY_FRAME:  return h->frame[metric];
+        case HISTORY_SECOND: return h->second[metric];
+        default:             return h->minute[metric];
+    }
+}
+
+static void accum_reset(HistoryAccum *a) {
+    a->min = 0.0f;
+    a->max = 0.0f;
+    a->sum = 0.0f;
+    a->n = 0;
+}
+
+static void accum_add(HistoryAccum *a, const HistorySample *s) {
+    if (a->n == 0 || s->min < a->min) a->min = s->min;
+    if (a->n == 0 || s->max > a->max) a->max = s->max;
+    a->sum += s->mean;
+    a->n++;
+}
+
+// Write one sample per metric into a tier and feed it to the next one up
+static void tier_push(History *h, HistoryTier tier, const HistorySample samples[HISTORY_METRIC_COUNT]) {
+    uint32_t slot = h->head[tier];
+
+    for (int m = 0; m < HISTORY_METRIC_COUNT; m++) {
+        tier_slots(h, tier, m)[slot] = samples[m];
+        if (tier + 1 < HISTORY_TIER_COUNT) {
+            accum_add(&h->accum[tier + 1][m], &samples[m]);
+        }
+    }
+
+    h->head[tier] = (slot + 1) % tier_capacity[tier];
+    if (h->count[tier] < (uint32_t)tier_capacity[tier]) {
+        h->count[tier]++;
+    }
+    h->total[tier]++;
+}
+
+// Close the accumulated samples of a tier into one downsampled entry
+static void tier_close(History *h, HistoryTier tier) {
+    HistorySample samples[HISTORY_METRIC_COUNT];
+
+    if (h->accum[tier][0].n == 0) {
+        return;
+    }
+
+    for (int m = 0; m < HISTORY_METRIC_COUNT; m++) {
+        HistoryAccum *a = &h->accum[tier][m];
+        samples[m].min = a->min;
+        samples[m].mean = a->sum / a->n;
+        samples[m].max = a->max;
+        accum_reset(a);
+    }
+    tier_push(h, tier, samples);
+}
+
+void history_init(History *h) {
+    memset(h, 0, sizeof(*h));
+}
+
+void history_record(History *h, const float values[HISTORY_METRIC_COUNT], uint32_t now_ms) {
+    HistorySample samples[HISTORY_METRIC_COUNT];
+
+    if (!h->started) {
+        h->second_start_ms = now_ms;
+        h->started = 1;
+    }
+
+    // Close every second that ended before this frame. A stall longer than
+    // a second closes only the one that holds data; the gap is not padded.
+    if (now_ms - h->second_start_ms >= SECOND_MS) {
+        tier_close(h, HISTORY_SECOND);
+        h->second_start_ms += ((now_ms - h->second_start_ms) / SECOND_MS) * SECOND_MS;
+
+        if (h->accum[HISTORY_MINUTE][0].n >= SECONDS_PER_MIN) {
+            tier_close(h, HISTORY_MINUTE);
+        }
+    }
+
+    for (int m = 0; m < HISTORY_METRIC_COUNT; m++) {
+        samples[m].min = samples[m].mean = samples[m].max = values[m];
+    }
+    tier_push(h, HISTORY_FRAME, samples);
+}
+
+int history_capacity(HistoryTier tier) {
+    return tier_capacity[tier];
+}
+
+int history_count(const History *h, HistoryTier tier) {
+    return (int)h->count[tier];
+}
+
+uint32_t history_total(const History *h, HistoryTier tier) {
+    return h->total[tier];
+}
+
+const HistorySample* history_get(const History *h, HistoryTier tier, HistoryMetric metric, int age) {
+    if (age < 0 || (uint32_t)age >= h->count[tier]) {
+        return NULL;
+    }
+
+    int capacity = tier_capacity[tier];
+    int slot = ((int)h->head[tier] - 1 - age + capacity) % capacity;
+    return &tier_slots((History *)h, tier, metric)[slot];
+}
@@ -0,0 +1,79 @@
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <stdint.h>
+
+#include "metrics.h"
+
+// Metric history with a fixed memory budget. Every metric keeps one ring
+// per resolution; a tier is filled by downsampling the one below it, so
+// hours of history fit in a few tens of KB that never grow.
+#define HISTORY_ID_HIST(id) HISTORY_##id,
+#define HISTORY_ID_NOHIST(id)
+
+// Registered metrics marked HIST (metrics.h), in table order
+typedef enum {
+#define HISTORY_ID(id, type, field, name, unit, sample, period, format, stats, history, ...) \
+    HISTORY_ID_##history(id)
+    METRIC_TABLE(HISTORY_ID)
+#undef HISTORY_ID
+    HISTORY_METRIC_COUNT
+} HistoryMetric;
+
+typedef enum {
+    HISTORY_FRAME = 0,      // One entry per record call
+    HISTORY_SECOND,
+    HISTORY_MINUTE,
+    HISTORY_TIER_COUNT
+} HistoryTier;
+
+#define HISTORY_FRAME_SLOTS  256    // ~4 s at 60 Hz
+#define HISTORY_SECOND_SLOTS 120    // 2 minutes
+#define HISTORY_MINUTE_SLOTS 240    // 4 hours
+
+typedef struct {
+    float min;
+    float mean;
+    float max;
+} HistorySample;
+
+// Running min/sum/max of the entries that will form the next coarser sample
+typedef struct {
+    float min;
+    float max;
+    float sum;
+    uint32_t n;
+} HistoryAccum;
+
+typedef struct {
+    HistorySample frame[HISTORY_METRIC_COUNT][HISTORY_FRAME_SLOTS];
+    HistorySample second[HISTORY_METRIC_COUNT][HISTORY_SECOND_SLOTS];
+    HistorySample minute[HISTORY_METRIC_COUNT][HISTORY_MINUTE_SLOTS];
+
+    // All metrics are recorded together, so they share ring positions
+    uint32_t head[HISTORY_TIER_COUNT];      // Next slot to write
+    uint32_t count[HISTORY_TIER_COUNT];     // Valid slots, up to capacity
+    uint32_t total[HISTORY_TIER_COUNT];     // Samples ever written
+
+    HistoryAccum accum[HISTORY_TIER_COUNT][HISTORY_METRIC_COUNT];
+    uint32_t second_start_ms;
+    int started;
+} History;
+
+extern const char* history_metric_names[HISTORY_METRIC_COUNT];
+extern const char* history_tier_names[HISTORY_TIER_COUNT];
+
+void history_init(History *h);
+
+// Add one frame of values. now_ms is a free-running millisecond clock; a
+// second sample closes every 1000 ms and a minute sample every 60 seconds.
+void history_record(History *h, const float values[HISTORY_METRIC_COUNT], uint32_t now_ms);
+
+int history_capacity(HistoryTier tier);
+int history_count(const History *h, HistoryTier tier);
+uint32_t history_total(const History *h, HistoryTier tier);
+
+// age 0 is the newest sample; NULL when age is out of range
+const HistorySample* history_get(const History *h, HistoryTier tier, HistoryMetric metric, int age);
+
+#endif /* HISTORY_H */
@@ -0,0 +1,48 @@
+#ifndef HW_H
+#define HW_H
+
+#include <stdint.h>
+
+// Memory map addresses for N64 hardware info
+#define MI_VERSION_REG  0xA4300004
+#define VI_CURRENT_REG  0xA4400004
+#define RI_CONFIG_REG   0xA4700004
+
+// RSP status register
+#define SP_STATUS_REG    0xA4040010
+#define SP_STATUS_HALTED 0x0001
+
+// RDP command interface (DPC) registers
+#define DPC_STATUS_REG   0xA410000C
+#define DPC_CLOCK_REG    0xA4100010
+#define DPC_BUFBUSY_REG  0xA4100014
+#define DPC_PIPEBUSY_REG 0xA4100018
+#define DPC_TMEM_REG     0xA410001C
+
+// DPC_STATUS read bits
+#define DPC_STATUS_PIPE_BUSY  0x020
+#define DPC_STATUS_CMD_BUSY   0x040
+
+// DPC_STATUS write bits that reset the RDP performance counters
+#define DPC_CLR_TMEM_CTR   0x040
+#define DPC_CLR_PIPE_CTR   0x080
+#define DPC_CLR_CMD_CTR    0x100
+#define DPC_CLR_CLOCK_CTR  0x200
+
+// DPC counters are 24 bits wide and count RDP (62.5 MHz) cycles
+#define DPC_COUNTER_MASK   0x00FFFFFF
+
+// Read COP0 register
+static inline uint32_t read_c0_count(void) {
+    uint32_t count;
+    asm volatile("mfc0 %0, $9" : "=r"(count));
+    return count;
+}
+
+static inline uint32_t read_c0_prid(void) {
+    uint32_t prid;
+    asm volatile("mfc0 %0, $15" : "=r"(prid));
+    return prid;
+}
+
+#endif /* HW_H */
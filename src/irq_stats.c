@@ -0,0 +1,151 @@
+#include <libdragon.h>
+#include <stdint.h>
+
+#include "irq_stats.h"
+#include "hw.h"
+
+const char* irq_source_names[IRQ_SOURCE_COUNT] = {
+    "SP",
+    "SI",
+    "AI",
+    "VI",
+    "PI",
+    "DP"
+};
+
+// Raw counters, written from interrupt context
+static volatile uint32_t irq_count[IRQ_SOURCE_COUNT];
+static volatile uint32_t irq_ticks[IRQ_SOURCE_COUNT];
+static volatile uint32_t irq_enter_count[IRQ_SOURCE_COUNT];
+static volatile uint8_t irq_active[IRQ_SOURCE_COUNT];
+
+static IrqSourceStats irq_stats[IRQ_SOURCE_COUNT];
+static float irq_total_load = 0.0f;
+
+static inline void irq_enter(IrqSource source) {
+    irq_enter_count[source] = read_c0_count();
+    irq_active[source] = 1;
+}
+
+static inline void irq_exit(IrqSource source) {
+    // Sources whose entry probe is not registered yet are not timed
+    if (!irq_active[source]) {
+        return;
+    }
+    irq_ticks[source] += read_c0_count() - irq_enter_count[source];
+    irq_count[source]++;
+    irq_active[source] = 0;
+}
+
+#define IRQ_PROBES(src) \
+    static void irq_enter_##src(void) { irq_enter(IRQ_##src); } \
+    static void irq_exit_##src(void)  { irq_exit(IRQ_##src); }
+
+IRQ_PROBES(SP)
+IRQ_PROBES(SI)
+IRQ_PROBES(AI)
+IRQ_PROBES(VI)
+IRQ_PROBES(PI)
+IRQ_PROBES(DP)
+
+typedef void (*irq_register_fn)(void (*callback)(void));
+
+static const irq_register_fn irq_register[IRQ_SOURCE_COUNT] = {
+    register_SP_handler,
+    register_SI_handler,
+    register_AI_handler,
+    register_VI_handler,
+    register_PI_handler,
+    register_DP_handler
+};
+
+static const irq_register_fn irq_unregister[IRQ_SOURCE_COUNT] = {
+    unregister_SP_handler,
+    unregister_SI_handler,
+    unregister_AI_handler,
+    unregister_VI_handler,
+    unregister_PI_handler,
+    unregister_DP_handler
+};
+
+static int head_registered = 0;
+
+static void (* const irq_enter_probes[IRQ_SOURCE_COUNT])(void) = {
+    irq_enter_SP, irq_enter_SI, irq_enter_AI, irq_enter_VI, irq_enter_PI, irq_enter_DP
+};
+
+static void (* const irq_exit_probes[IRQ_SOURCE_COUNT])(void) = {
+    irq_exit_SP, irq_exit_SI, irq_exit_AI, irq_exit_VI, irq_exit_PI, irq_exit_DP
+};
+
+void irq_stats_init_tail(void) {
+    for (int i = 0; i < IRQ_SOURCE_COUNT; i++) {
+        irq_register[i](irq_exit_probes[i]);
+    }
+}
+
+void irq_stats_init_head(void) {
+    // Move the entry probes to the front rather than adding another set
+    disable_interrupts();
+    for (int i = 0; i < IRQ_SOURCE_COUNT; i++) {
+        if (head_registered) {
+            irq_unregister[i](irq_enter_probes[i]);
+        }
+        irq_register[i](irq_enter_probes[i]);
+    }
+    head_registered = 1;
+    enable_interrupts();
+}
+
+void irq_stats_update(void) {
+    static uint32_t window_start = 0;
+    static uint32_t last_count[IRQ_SOURCE_COUNT];
+    static uint32_t last_ticks[IRQ_SOURCE_COUNT];
+    static int started = 0;
+
+    uint32_t now = read_c0_count();
+
+    if (!started) {
+        window_start = now;
+        for (int i = 0; i < IRQ_SOURCE_COUNT; i++) {
+            last_count[i] = irq_count[i];
+            last_ticks[i] = irq_ticks[i];
+        }
+        started = 1;
+        return;
+    }
+
+    uint32_t elapsed = now - window_start;
+    if (elapsed < TICKS_PER_SECOND) {
+        return;
+    }
+
+    float seconds = (float)elapsed / (float)TICKS_PER_SECOND;
+    irq_total_load = 0.0f;
+
+    for (int i = 0; i < IRQ_SOURCE_COUNT; i++) {
+        uint32_t count = irq_count[i];
+        uint32_t ticks = irq_ticks[i];
+        uint32_t delta_count = count - last_count[i];
+        uint32_t delta_ticks = ticks - last_ticks[i];
+
+        // COUNT runs at half the CPU clock: one tick is 1/46.875 us
+        irq_stats[i].per_sec = (uint32_t)(delta_count / seconds + 0.5f);
+        irq_stats[i].handler_us = (uint32_t)(delta_ticks / seconds / (TICKS_PER_SECOND / 1000000.0f));
+        irq_stats[i].load_percent = (float)delta_ticks * 100.0f / (float)elapsed;
+        irq_total_load += irq_stats[i].load_percent;
+
+        last_count[i] = count;
+        last_ticks[i] = ticks;
+    }
+
+    window_start = now;
+}
+
+const IrqSourceStats* irq_stats_get(IrqSource source) {
+    return &irq_stats[source];
+}
+
+float irq_stats_total_load(void) {
+    return irq_total_load;
+}
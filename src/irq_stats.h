@@ -0,0 +1,39 @@
+#ifndef IRQ_STATS_H
+#define IRQ_STATS_H
+
+#include <stdint.h>
+
+// MI interrupt sources, in MI_INTR bit order
+typedef enum {
+    IRQ_SP = 0,
+    IRQ_SI,
+    IRQ_AI,
+    IRQ_VI,
+    IRQ_PI,
+    IRQ_DP,
+    IRQ_SOURCE_COUNT
+} IrqSource;
+
+typedef struct {
+    uint32_t per_sec;       // Interrupts in the last second
+    uint32_t handler_us;    // CPU time spent in this source's callbacks, per second
+    float load_percent;     // handler_us as a share of CPU time
+} IrqSourceStats;
+
+extern const char* irq_source_names[IRQ_SOURCE_COUNT];
+
+// Interrupt accounting wraps every source's callback chain with a pair of
+// probes. libdragon runs callbacks newest-first, so the exit probes must be
+// registered before any other subsystem (display, rdpq, ...) and the entry
+// probes after all of them. irq_stats_init_head can be called again after a
+// subsystem registers a new handler; it moves the entry probes back in front.
+void irq_stats_init_tail(void);
+void irq_stats_init_head(void);
+
+// Fold the raw counters into per-second figures (called every frame)
+void irq_stats_update(void);
+
+const IrqSourceStats* irq_stats_get(IrqSource source);
+float irq_stats_total_load(void);
+
+#endif /* IRQ_STATS_H */
@@ -0,0 +1,119 @@
+#include <libdragon.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "layout.h"
+#include "fmt.h"
+#include "ui.h"
+
+void layout_draw(display_context_t disp, const Layout *layout) {
+    int y = UI_CONTENT_Y;
+
+    for (int i = 0; i < layout->count; i++) {
+        const LayoutRow *row = &layout->rows[i];
+
+        if (!row->label) {
+            if (i > 0) {
+                y += 3;
+            }
+            ui_draw_text(disp, 15, y, row->text);
+            y += UI_LINE_HEIGHT + 2;
+            continue;
+        }
+
+        if (!row->field) {
+            draw_label_value(disp, 20, y, row->label, row->text);
+            y += UI_LINE_HEIGHT;
+            continue;
+        }
+
+        // The field slot still gets its draw call, which keeps every
+        // framebuffer up to date; only the formatting is skipped
+        LayoutCache *cache = &layout->cache[i];
+        if (!cache->valid || memcmp(cache->raw, row->field, row->size) != 0) {
+            char *end = row->format(cache->text, row->field);
+            if (row->text) {
+                fmt_str(end, row->text);
+            }
+            if (row->check) {
+                layout_fmt_deviation(cache->deviation, row->check);
+            }
+            memcpy(cache->raw, row->field, row->size);
+            cache->valid = 1;
+        }
+
+        if (!row->check) {
+            draw_label_value(disp, 20, y, row->label, cache->text);
+            y += UI_LINE_HEIGHT;
+            continue;
+        }
+
+        // Value and deviation in the color of the verdict, which only
+        // changes together with the field
+        char label[LAYOUT_VALUE_CHARS];
+        int len = fmt_str(fmt_pad(label, row->label, 20), " : ") - label;
+        ui_draw_text(disp, 20, y, label);
+        ui_set_color(layout_verdict_color(row->check->verdict), UI_COLOR_BACKGROUND);
+        ui_draw_field(disp, 20 + LAYOUT_DEVIATION_X * 8, y, cache->deviation);
+        ui_draw_field(disp, 20 + len * 8, y, cache->text);
+        ui_set_color(UI_COLOR_TEXT, UI_COLOR_BACKGROUND);
+        y += UI_LINE_HEIGHT;
+    }
+}
+
+UiColor layout_verdict_color(BaselineVerdict verdict) {
+    switch (verdict) {
+        case BASELINE_PASS: return UI_COLOR_GREEN;
+        case BASELINE_WARN: return UI_COLOR_YELLOW;
+        case BASELINE_FAIL: return UI_COLOR_RED;
+        default:            return UI_COLOR_TEXT;
+    }
+}
+
+char* layout_fmt_deviation(char *dst, const BaselineCheck *check) {
+    char value[FMT_MAX];
+
+    if (check->verdict == BASELINE_UNCHECKED) {
+        return fmt_rjust(dst, "", 7);
+    }
+
+    // Clamped so that the text always fits its column
+    float pct = check->deviation_pct;
+    if (pct > 999.9f) pct = 999.9f;
+    if (pct < -999.9f) pct = -999.9f;
+
+    char *p = value;
+    if (pct >= 0.0f) {
+        *p++ = '+';
+    }
+    fmt_str(fmt_float(p, pct, 1), "%");
+    return fmt_rjust(dst, value, 7);
+}
+
+char* layout_fmt_str(char *dst, const void *field) {
+    return fmt_str(dst, *(const char* const *)field);
+}
+
+char* layout_fmt_u32(char *dst, const void *field) {
+    return fmt_u32(dst, *(const uint32_t *)field);
+}
+
+char* layout_fmt_hex32(char *dst, const void *field) {
+    return fmt_hex32(dst, *(const uint32_t *)field);
+}
+
+char* layout_fmt_float1(char *dst, const void *field) {
+    return fmt_float(dst, *(const float *)field, 1);
+}
+
+char* layout_fmt_float2(char *dst, const void *field) {
+    return fmt_float(dst, *(const float *)field, 2);
+}
+
+char* layout_fmt_mhz(char *dst, const void *field) {
+    return fmt_mhz(dst, *(const float *)field);
+}
+
+char* layout_fmt_mbps(char *dst, const void *field) {
+    return fmt_mbps(dst, *(const uint32_t *)field);
+}
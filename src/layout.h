@@ -0,0 +1,70 @@
+#ifndef LAYOUT_H
+#define LAYOUT_H
+
+#include <libdragon.h>
+#include <stdint.h>
+
+#include "baseline.h"
+#include "ui.h"
+
+#define LAYOUT_RAW_MAX     16   // Largest metric compared by value
+#define LAYOUT_VALUE_CHARS 32
+#define LAYOUT_DEVIATION_X 13   // Column of the deviation, inside the label pad
+
+// One line of an information tab. Tables are static const, so they live in
+// read-only data; adding a metric is one more row.
+//   section:  label == NULL, text is the heading
+//   constant: field == NULL, text is the value
+//   metric:   format turns *field into text, followed by the suffix in text
+//   checked:  a metric colored by its reference check, with the deviation
+//             shown in front of the value (labels of at most 12 characters)
+typedef struct {
+    const char *label;
+    const char *text;
+    const void *field;
+    uint8_t size;                                   // sizeof(*field)
+    char* (*format)(char *dst, const void *field);  // Returns the end of dst
+    const BaselineCheck *check;                     // Updated with *field
+} LayoutRow;
+
+#define LAYOUT_SECTION(title)                { NULL, title, NULL, 0, NULL, NULL }
+#define LAYOUT_TEXT(label, value)            { label, value, NULL, 0, NULL, NULL }
+#define LAYOUT_METRIC(label, var, fmt, suffix) { label, suffix, &(var), sizeof(var), fmt, NULL }
+#define LAYOUT_CHECKED(label, var, fmt, suffix, check) \
+    { label, suffix, &(var), sizeof(var), fmt, &(check) }
+
+// Last formatted value of each metric row. A row is only formatted again
+// when the raw bytes of its field change.
+typedef struct {
+    uint8_t raw[LAYOUT_RAW_MAX];
+    char text[LAYOUT_VALUE_CHARS];
+    char deviation[8];
+    uint8_t valid;
+} LayoutCache;
+
+typedef struct {
+    const LayoutRow *rows;
+    LayoutCache *cache;     // One entry per row
+    int count;
+} Layout;
+
+#define LAYOUT_COUNT(rows) (int)(sizeof(rows) / sizeof(rows[0]))
+
+// Walk a table from the top of the content area
+void layout_draw(display_context_t disp, const Layout *layout);
+
+// Color of a reference verdict, and its deviation right-justified to 7
+// characters as "  +1.2%" (blank when unchecked)
+UiColor layout_verdict_color(BaselineVerdict verdict);
+char* layout_fmt_deviation(char *dst, const BaselineCheck *check);
+
+// Formatters for common field types
+char* layout_fmt_str(char *dst, const void *field);      // const char *
+char* layout_fmt_u32(char *dst, const void *field);      // uint32_t
+char* layout_fmt_hex32(char *dst, const void *field);    // uint32_t
+char* layout_fmt_float1(char *dst, const void *field);   // float, 1 decimal
+char* layout_fmt_float2(char *dst, const void *field);   // float, 2 decimals
+char* layout_fmt_mhz(char *dst, const void *field);      // float
+char* layout_fmt_mbps(char *dst, const void *field);     // uint32_t
+
+#endif /* LAYOUT_H */
@@ -1,13 +1,30 @@
 #include <libdragon.h>
 #include <stdio.h>
 #include <stdint.h>
+#include <string.h>
 
+#include "baseline.h"
 #include "cpu_revision.h"
-
-// Memory map addresses for N64 hardware info
-#define MI_VERSION_REG  0xA4300004
-#define VI_CURRENT_REG  0xA4400004
-#define RI_CONFIG_REG   0xA4700004
+#include "hw.h"
+#include "fmt.h"
+#include "graph.h"
+#include "history.h"
+#include "layout.h"
+#include "measurements.h"
+#include "ui.h"
+#include "bench.h"
+#include "bench_tmem.h"
+#include "bench_tri.h"
+#include "bench_mmio.h"
+#include "bench_fmt.h"
+#include "bench_text.h"
+#include "compare.h"
+#include "irq_stats.h"
+#include "results.h"
+#include "telemetry.h"
+#include "timeline.h"
+#include "profiler.h"
+#include "settings.h"
 
 // Tab system
 typedef enum {
@@ -15,6 +32,9 @@ typedef enum {
     TAB_MEMORY,
     TAB_RCP,
     TAB_VIDEO,
+    TAB_LIVE,
+    TAB_BENCH,
+    TAB_SETUP,
     TAB_COUNT
 } Tab;
 
@@ -22,49 +42,46 @@ const char* tab_names[TAB_COUNT] = {
     "CPU",
     "Memory", 
     "RCP",
-    "Video"
+    "Video",
+    "Live",
+    "Bench",
+    "Setup"
 };
 
-// Measurement structure for continuous monitoring
-typedef struct {
-    // CPU measurements
-    float cpu_freq_current;
-    float cpu_freq_min;
-    float cpu_freq_max;
-    uint32_t cpu_cycles_per_frame;
-    
-    // Memory measurements
-    uint32_t rdram_bandwidth;  // MB/s
-    uint32_t rdram_latency;    // cycles
-    
-    // RCP measurements
-    float rsp_load_percent;
-    float rdp_load_percent;
-    uint32_t vi_interrupts_per_sec;
-    
-    // Video measurements
-    uint32_t current_scanline;
-    float actual_fps;
-    
-    // Timing
-    uint32_t frames_counted;
-    uint32_t last_count;
-} SystemMeasurements;
+// On-demand benchmarks, selected with D-Up/D-Down on the Bench tab
+static const Benchmark* benchmarks[] = {
+    &bench_tmem,
+    &bench_tri,
+    &bench_mmio,
+    &bench_fmt,
+    &bench_text,
+};
+#define BENCH_COUNT (int)(sizeof(benchmarks) / sizeof(benchmarks[0]))
 
-static SystemMeasurements measurements = {0};
+// Pages per tab, switched with D-Left/D-Right
+// (the Bench tab pages through the selected benchmark's results instead)
+static const int tab_page_counts[TAB_COUNT] = {
+    2,  // CPU: specifications, reference check
+    1,  // Memory
+    2,  // RCP: specifications, interrupts
+    2,  // Video: display mode, real-time status
+    5,  // Live: frame timeline, frame budget, worst frames, graphs, metrics
+    1,  // Bench
+    3   // Setup: settings, costs, A/B compare
+};
 
-// Read COP0 register
-static inline uint32_t read_c0_count(void) {
-    uint32_t count;
-    asm volatile("mfc0 %0, $9" : "=r"(count));
-    return count;
+int tab_page_count(Tab tab, int bench_index) {
+    if (tab == TAB_BENCH) {
+        return benchmarks[bench_index]->pages + 1;    // + saved results
+    }
+    return tab_page_counts[tab];
 }
 
-static inline uint32_t read_c0_prid(void) {
-    uint32_t prid;
-    asm volatile("mfc0 %0, $15" : "=r"(prid));
-    return prid;
-}
+// Latest measurement snapshot, refreshed once per rendered frame
+static SystemMeasurements measurements = {0};
+
+// Per-frame, per-second and per-minute history of the snapshot
+static History history;
 
 // Detect memory size
 uint32_t detect_memory_size(void) {
@@ -83,15 +100,6 @@ const char* get_tv_type_string(void) {
     }
 }
 
-float get_tv_refresh_rate(void) {
-    switch(get_tv_type()) {
-        case TV_PAL: return 50.0f;
-        case TV_NTSC: return 60.0f;
-        case TV_MPAL: return 60.0f;
-        default: return 60.0f;
-    }
-}
-
 // Read RCP version
 uint32_t get_rcp_version(void) {
     volatile uint32_t *mi_version = (uint32_t *)MI_VERSION_REG;
@@ -104,432 +112,428 @@ uint32_t get_rdram_config(void) {
     return *ri_config;
 }
 
-// Measure CPU frequency continuously
-void measure_cpu_frequency_continuous(void) {
-    static uint32_t last_frame_count = 0;
-    static uint32_t measure_start_count = 0;
-    static int measuring = 0;
-    
-    uint32_t current_count = read_c0_count();
-    
-    if (!measuring) {
-        measure_start_count = current_count;
-        last_frame_count = measurements.frames_counted;
-        measuring = 1;
-        return;
-    }
-    
-    uint32_t frames_elapsed = measurements.frames_counted - last_frame_count;
-    
-    // Update every 5 frames for accuracy
-    if (frames_elapsed >= 5) {
-        uint32_t count_delta = current_count - measure_start_count;
-        uint64_t cpu_cycles = (uint64_t)count_delta * 2; // COUNT is half CPU speed
-        
-        float frame_rate = get_tv_refresh_rate();
-        float cpu_freq = ((float)cpu_cycles / (float)frames_elapsed) * frame_rate / 1000000.0f;
-        
-        measurements.cpu_freq_current = cpu_freq;
-        measurements.cpu_cycles_per_frame = (uint32_t)(cpu_cycles / frames_elapsed);
-        
-        // Track min/max
-        if (measurements.cpu_freq_min == 0 || cpu_freq < measurements.cpu_freq_min) {
-            measurements.cpu_freq_min = cpu_freq;
-        }
-        if (cpu_freq > measurements.cpu_freq_max) {
-            measurements.cpu_freq_max = cpu_freq;
-        }
-        
-        measuring = 0;
-    }
-}
+// Values shown by the layout tables. Static information is filled in once,
+// the rest is derived from the snapshot every rendered frame.
+static struct {
+    uint32_t prid;
+    const char *cpu_revision;
+    uint32_t memory_mb;
+    const char *expansion;
+    const char *expansion_range;
+    uint32_t rcp_version;
+    const char *tv_type;
+    float refresh_rate;
+    uint32_t resolution[2];         // Width, height
+    const char *depth_name;
+    const char *pixel_format;
+    uint32_t framebuffer_kb[2];     // Total, saved against 32 bpp
+    float scanout_mbps[2];          // Total, saved against 32 bpp
+    uint32_t reference_mbps;
+} info;
 
-// Measure memory bandwidth (approximate via timing)
-void measure_memory_bandwidth(void) {
-    static uint32_t last_measure_frame = 0;
-    
-    if (measurements.frames_counted - last_measure_frame < 30) {
-        return; // Measure every 30 frames (0.5 sec)
-    }
-    
-    last_measure_frame = measurements.frames_counted;
-    
-    // Allocate dedicated uncached buffers to avoid stomping code/data
-    // Use uncached memory (KSEG1: 0xA0000000) to avoid cache effects
-    #define BW_TEST_SIZE 4096  // 4KB test
-    static uint32_t src_buffer[BW_TEST_SIZE / 4] __attribute__((aligned(16)));
-    static uint32_t dst_buffer[BW_TEST_SIZE / 4] __attribute__((aligned(16)));
-    
-    // Use uncached addresses to bypass cache
-    uintptr_t src_phys = ((uintptr_t)src_buffer & 0x1FFFFFFF) | 0xA0000000;
-    uintptr_t dst_phys = ((uintptr_t)dst_buffer & 0x1FFFFFFF) | 0xA0000000;
-    volatile uint32_t *src = (volatile uint32_t *)src_phys;
-    volatile uint32_t *dst = (volatile uint32_t *)dst_phys;
-    
-    // Initialize source buffer
-    for (int i = 0; i < BW_TEST_SIZE / 4; i++) {
-        src[i] = i;
-    }
-    
-    // Flush data cache to ensure clean test
-    data_cache_hit_writeback_invalidate(src_buffer, BW_TEST_SIZE);
-    data_cache_hit_writeback_invalidate(dst_buffer, BW_TEST_SIZE);
-    
-    uint32_t count_start = read_c0_count();
-    
-    // Copy 4KB using uncached access (tests actual RDRAM speed)
-    for (int i = 0; i < BW_TEST_SIZE / 4; i++) {
-        dst[i] = src[i];
-    }
-    
-    uint32_t count_end = read_c0_count();
-    uint64_t cycles = (uint64_t)(count_end - count_start) * 2;
-    
-    // Calculate bandwidth: bytes / (cycles / CPU_freq)
-    if (measurements.cpu_freq_current > 0) {
-        float time_seconds = (float)cycles / (measurements.cpu_freq_current * 1000000.0f);
-        float bandwidth_mbps = (BW_TEST_SIZE / time_seconds) / (1024.0f * 1024.0f);
-        measurements.rdram_bandwidth = (uint32_t)bandwidth_mbps;
-    }
-    #undef BW_TEST_SIZE
-}
+// Reference entry for this console, and the latest snapshot checked
+// against it (one value and verdict per BaselineMetric)
+static const BaselineEntry *reference;
+static float reference_values[BASELINE_METRIC_COUNT];
+static BaselineCheck reference_checks[BASELINE_METRIC_COUNT];
 
-// Measure current video scanline
-void measure_video_scanline(void) {
-    volatile uint32_t *vi_current = (uint32_t *)VI_CURRENT_REG;
-    measurements.current_scanline = (*vi_current >> 1) & 0x3FF;
+static const uint8_t reference_decimals[BASELINE_METRIC_COUNT] = {
+    [BASELINE_CPU_MHZ]    = 2,
+    [BASELINE_BANDWIDTH]  = 0,
+    [BASELINE_REFRESH]    = 2,
+    [BASELINE_VI_PER_SEC] = 0,
+    [BASELINE_FPS]        = 1,
+};
+
+static char* fmt_resolution(char *dst, const void *field) {
+    const uint32_t *r = field;
+    return fmt_u32(fmt_str(fmt_u32(dst, r[0]), " x "), r[1]);
 }
 
-// Calculate actual FPS
-void calculate_fps(void) {
-    static uint32_t last_fps_frame = 0;
-    static uint32_t last_fps_count = 0;
-    static int first_sample = 1;
-    
-    // Initialize on first call
-    if (first_sample && measurements.frames_counted >= 60) {
-        last_fps_frame = measurements.frames_counted;
-        last_fps_count = read_c0_count();
-        first_sample = 0;
-        return;
-    }
+static const LayoutRow cpu_rows[] = {
+    LAYOUT_SECTION("Processor"),
+    LAYOUT_TEXT("Name", "MIPS VR4300i"),
+    LAYOUT_METRIC("Revision", info.cpu_revision, layout_fmt_str, NULL),
+    LAYOUT_METRIC("Code Name", info.prid, layout_fmt_hex32, NULL),
+    LAYOUT_TEXT("Package", "Single-Chip"),
+    LAYOUT_TEXT("Technology", "0.35um / 0.18um"),
 
-    uint32_t frames_elapsed = measurements.frames_counted - last_fps_frame;
+    LAYOUT_SECTION("Specification"),
+    LAYOUT_TEXT("Instruction Set", "MIPS III (64-bit)"),
 
-    if (frames_elapsed >= 60) {
-        uint32_t current_count = read_c0_count();
-        uint32_t count_delta = current_count - last_fps_count;
-        uint64_t cpu_cycles = (uint64_t)count_delta * 2;
+    LAYOUT_SECTION("Clocks (Real-Time)"),
+    LAYOUT_CHECKED("Core Speed", measurements.cpu_freq_current, layout_fmt_mhz, NULL,
+                   reference_checks[BASELINE_CPU_MHZ]),
+    LAYOUT_TEXT("Multiplier", "x1.0"),
+    LAYOUT_METRIC("Bus Speed", measurements.cpu_freq_current, layout_fmt_mhz, NULL),
 
-        if (measurements.cpu_freq_current > 0 && frames_elapsed > 0) {
-            float time_seconds = (float)cpu_cycles / (measurements.cpu_freq_current * 1000000.0f);
-            measurements.actual_fps = frames_elapsed / time_seconds;
-        }
+    LAYOUT_SECTION("Cache"),
+    LAYOUT_TEXT("L1 Data", "16 KB"),
+    LAYOUT_TEXT("L1 Instruction", "16 KB"),
+
+    LAYOUT_SECTION("Frequency Range"),
+    LAYOUT_METRIC("Min", measurements.cpu_freq_current_min, layout_fmt_mhz, NULL),
+    LAYOUT_METRIC("Max", measurements.cpu_freq_current_max, layout_fmt_mhz, NULL),
+};
+
+static const LayoutRow memory_rows[] = {
+    LAYOUT_SECTION("General"),
+    LAYOUT_TEXT("Type", "Rambus DRAM"),
+    LAYOUT_METRIC("Size", info.memory_mb, layout_fmt_u32, " MB"),
+    LAYOUT_METRIC("Expansion Pak", info.expansion, layout_fmt_str, NULL),
+
+    LAYOUT_SECTION("Timings (Real-Time)"),
+    LAYOUT_TEXT("Frequency", "250 MHz"),
+    LAYOUT_CHECKED("Bandwidth", measurements.rdram_bandwidth, layout_fmt_mbps, NULL,
+                   reference_checks[BASELINE_BANDWIDTH]),
+    LAYOUT_METRIC("Reference", info.reference_mbps, layout_fmt_mbps, NULL),
+    LAYOUT_TEXT("Bus Width", "9-bit"),
+    LAYOUT_TEXT("Theoretical Max", "562 MB/s"),
+
+    LAYOUT_SECTION("Physical Memory"),
+    LAYOUT_TEXT("Base RDRAM", "0x00000000-0x003FFFFF"),
+    LAYOUT_METRIC("Expansion", info.expansion_range, layout_fmt_str, NULL),
+    LAYOUT_TEXT("MMIO Start", "0x04000000"),
+};
+
+static const LayoutRow rcp_rows[] = {
+    LAYOUT_SECTION("Reality Co-Processor"),
+    LAYOUT_METRIC("Version", info.rcp_version, layout_fmt_hex32, NULL),
+    LAYOUT_TEXT("Clock", "62.5 MHz"),
+
+    LAYOUT_SECTION("RSP (Reality Signal Processor)"),
+    LAYOUT_TEXT("Type", "Vector Processor"),
+    LAYOUT_TEXT("Clock", "62.5 MHz"),
+    LAYOUT_TEXT("DMEM", "4 KBytes"),
+    LAYOUT_TEXT("IMEM", "4 KBytes"),
+    LAYOUT_TEXT("Vector Unit", "8 x 128-bit regs"),
+
+    LAYOUT_SECTION("RDP (Reality Display Processor)"),
+    LAYOUT_TEXT("Type", "Rasterizer"),
+    LAYOUT_TEXT("Clock", "62.5 MHz"),
+    LAYOUT_TEXT("TMEM", "4 KBytes"),
+    LAYOUT_TEXT("Fill Rate", "~100 Mpixels/s"),
+    LAYOUT_TEXT("Texture Formats", "Multiple"),
+};
+
+static const LayoutRow video_rows[] = {
+    LAYOUT_SECTION("Video Interface"),
+    LAYOUT_METRIC("TV System", info.tv_type, layout_fmt_str, NULL),
+    LAYOUT_CHECKED("Refresh Rate", info.refresh_rate, layout_fmt_float1, " Hz",
+                   reference_checks[BASELINE_REFRESH]),
+
+    LAYOUT_SECTION("Current Mode"),
+    LAYOUT_METRIC("Resolution", info.resolution, fmt_resolution, NULL),
+    LAYOUT_METRIC("Color Depth", info.depth_name, layout_fmt_str, NULL),
+    LAYOUT_METRIC("Pixel Format", info.pixel_format, layout_fmt_str, NULL),
+    LAYOUT_METRIC("Framebuffers", info.framebuffer_kb[0], layout_fmt_u32, " KB"),
+    LAYOUT_METRIC("Framebuffers Saved", info.framebuffer_kb[1], layout_fmt_u32, " KB"),
+    LAYOUT_METRIC("Scanout", info.scanout_mbps[0], layout_fmt_float1, " MB/s"),
+    LAYOUT_METRIC("Scanout Saved", info.scanout_mbps[1], layout_fmt_float1, " MB/s"),
+};
+
+static const LayoutRow video_status_rows[] = {
+    LAYOUT_SECTION("Real-Time Status"),
+    LAYOUT_METRIC("Current Scanline", measurements.current_scanline, layout_fmt_u32, NULL),
+    LAYOUT_CHECKED("Actual FPS", measurements.actual_fps, layout_fmt_float1, " fps",
+                   reference_checks[BASELINE_FPS]),
+    LAYOUT_METRIC("Frame Count", measurements.frames_counted, layout_fmt_u32, NULL),
+    LAYOUT_METRIC("Samples Taken", measurements.samples_taken, layout_fmt_u32, NULL),
+};
 
-        last_fps_frame = measurements.frames_counted;
-        last_fps_count = current_count;
+// Every registered metric with its session range, expanded from metrics.h
+#define METRIC_ROWS_RANGE(name, field, format, unit)                           \
+    LAYOUT_METRIC(name, measurements.field, format, " " unit),              \
+    LAYOUT_METRIC(name " Min", measurements.field##_min, format, " " unit), \
+    LAYOUT_METRIC(name " Max", measurements.field##_max, format, " " unit),
+#define METRIC_ROWS_NONE(name, field, format, unit) \
+    LAYOUT_METRIC(name, measurements.field, format, " " unit),
+#define METRIC_ROWS(id, type, field, name, unit, sample, period, format, stats, ...) \
+    METRIC_ROWS_##stats(name, field, format, unit)
+
+static const LayoutRow metric_rows[] = {
+    LAYOUT_SECTION("Registered Metrics"),
+    METRIC_TABLE(METRIC_ROWS)
+};
+
+#undef METRIC_ROWS
+
+static LayoutCache cpu_cache[LAYOUT_COUNT(cpu_rows)];
+static LayoutCache memory_cache[LAYOUT_COUNT(memory_rows)];
+static LayoutCache rcp_cache[LAYOUT_COUNT(rcp_rows)];
+static LayoutCache video_cache[LAYOUT_COUNT(video_rows)];
+static LayoutCache video_status_cache[LAYOUT_COUNT(video_status_rows)];
+static LayoutCache metric_cache[LAYOUT_COUNT(metric_rows)];
+
+static const Layout cpu_layout = { cpu_rows, cpu_cache, LAYOUT_COUNT(cpu_rows) };
+static const Layout memory_layout = { memory_rows, memory_cache, LAYOUT_COUNT(memory_rows) };
+static const Layout rcp_layout = { rcp_rows, rcp_cache, LAYOUT_COUNT(rcp_rows) };
+static const Layout video_layout = { video_rows, video_cache, LAYOUT_COUNT(video_rows) };
+static const Layout video_status_layout = { video_status_rows, video_status_cache,
+                                            LAYOUT_COUNT(video_status_rows) };
+static const Layout metric_layout = { metric_rows, metric_cache, LAYOUT_COUNT(metric_rows) };
+
+// Fill in the values that never change while running
+void init_info(void) {
+    info.prid = read_c0_prid();
+    info.cpu_revision = get_cpu_revision(info.prid);
+    info.memory_mb = detect_memory_size();
+    info.expansion = (info.memory_mb == 8) ? "Yes" : "No";
+    info.expansion_range = (info.memory_mb == 8) ? "0x00400000-0x007FFFFF" : "Not installed";
+    info.rcp_version = get_rcp_version();
+    info.tv_type = get_tv_type_string();
+    info.refresh_rate = get_tv_refresh_rate();
+
+    BaselineRegion region;
+    switch (get_tv_type()) {
+        case TV_NTSC: region = BASELINE_NTSC; break;
+        case TV_PAL:  region = BASELINE_PAL; break;
+        case TV_MPAL: region = BASELINE_MPAL; break;
+        default:      region = BASELINE_ANY_REGION; break;
     }
+    reference = baseline_select(info.rcp_version, region, info.memory_mb);
+    info.reference_mbps = (uint32_t)reference->refs[BASELINE_BANDWIDTH].expected;
 }
 
-// Update all measurements (called every frame)
-void update_measurements(void) {
-    measurements.frames_counted++;
+// Display mode values, derived again every frame since the mode can change
+void update_video_info(void) {
+    int is_16bpp = (ui_display_depth() == UI_DEPTH_16);
+    uint32_t width = display_get_width();
+    uint32_t height = display_get_height();
+    uint32_t buffers = display_get_num_buffers();
 
-    measure_cpu_frequency_continuous();
-    measure_video_scanline();
+    info.resolution[0] = width;
+    info.resolution[1] = height;
+    info.depth_name = is_16bpp ? "16-bit RGBA" : "32-bit RGBA";
+    info.pixel_format = is_16bpp ? "RGBA 5551" : "RGBA 8888";
 
-    calculate_fps();
-    
-    // Less frequent measurements
-    if (measurements.frames_counted % 30 == 0) {
-        measure_memory_bandwidth();
-    }
+    // Every buffer is scanned out by the VI once per refresh
+    uint32_t frame_bytes = width * height * (is_16bpp ? 2 : 4);
+    uint32_t scanout = (uint32_t)(frame_bytes * info.refresh_rate) / 1000;
+
+    info.framebuffer_kb[0] = frame_bytes * buffers / 1024;
+    info.framebuffer_kb[1] = is_16bpp ? frame_bytes * buffers / 1024 : 0;
+    info.scanout_mbps[0] = scanout / 1000.0f;
+    info.scanout_mbps[1] = is_16bpp ? scanout / 1000.0f : 0.0f;
 }
 
-// Draw a labeled value
-void draw_label_value(display_context_t disp, int x, int y, const char* label, const char* value) {
-    char buffer[128];
-    snprintf(buffer, sizeof(buffer), "%-20s : %s", label, value);
-    graphics_draw_text(disp, x, y, buffer);
+#define HISTORY_VALUE_HIST(id, field) [HISTORY_##id] = (float)measurements.field,
+#define HISTORY_VALUE_NOHIST(id, field)
+
+// Add the snapshot to the history. VI frames are the clock, so the second
+// and minute tiers stay in real time whatever the render rate.
+void record_history(void) {
+    float values[HISTORY_METRIC_COUNT] = {
+#define HISTORY_VALUE(id, type, field, name, unit, sample, period, format, stats, history, ...) \
+        HISTORY_VALUE_##history(id, field)
+        METRIC_TABLE(HISTORY_VALUE)
+#undef HISTORY_VALUE
+    };
+    uint32_t now_ms = (uint32_t)((uint64_t)measurements.frames_counted * 1000 / (uint32_t)info.refresh_rate);
+    history_record(&history, values, now_ms);
 }
 
-// Draw CPU tab
-void draw_cpu_tab(display_context_t disp, uint32_t prid) {
-    int y = 50;
-    int line_height = 11;
-    char buffer[128];
-    
-    // Processor section
-    graphics_draw_text(disp, 15, y, "Processor");
-    y += line_height + 2;
-    
-    draw_label_value(disp, 20, y, "Name", "MIPS VR4300i");
-    y += line_height;
-    
-    snprintf(buffer, sizeof(buffer), "%s", get_cpu_revision(prid));
-    draw_label_value(disp, 20, y, "Revision", buffer);
-    y += line_height;
-    
-    snprintf(buffer, sizeof(buffer), "0x%08X", prid);
-    draw_label_value(disp, 20, y, "Code Name", buffer);
-    y += line_height;
-    
-    draw_label_value(disp, 20, y, "Package", "Single-Chip");
-    y += line_height;
-    
-    draw_label_value(disp, 20, y, "Technology", "0.35um / 0.18um");
-    y += line_height;
-    
-    y += 3;
-    
-    // Specification section
-    graphics_draw_text(disp, 15, y, "Specification");
-    y += line_height + 2;
-    
-    draw_label_value(disp, 20, y, "Instruction Set", "MIPS III (64-bit)");
-    y += line_height;
-    
-    y += 3;
-    
-    // Clocks section - REAL-TIME MEASUREMENTS
-    graphics_draw_text(disp, 15, y, "Clocks (Real-Time)");
-    y += line_height + 2;
-    
-    snprintf(buffer, sizeof(buffer), "%.2f MHz", measurements.cpu_freq_current);
-    draw_label_value(disp, 20, y, "Core Speed", buffer);
-    y += line_height;
-    
-    draw_label_value(disp, 20, y, "Multiplier", "x1.0");
-    y += line_height;
-    
-    snprintf(buffer, sizeof(buffer), "%.2f MHz", measurements.cpu_freq_current);
-    draw_label_value(disp, 20, y, "Bus Speed", buffer);
-    y += line_height;
-    
-    y += 3;
-    
-    // Cache section
-    graphics_draw_text(disp, 15, y, "Cache");
-    y += line_height + 2;
-    
-    draw_label_value(disp, 20, y, "L1 Data", "16 KB");
-    y += line_height;
+// Grade the snapshot against the reference entry
+void check_reference(void) {
+    reference_values[BASELINE_CPU_MHZ] = measurements.cpu_freq_current;
+    reference_values[BASELINE_BANDWIDTH] = (float)measurements.rdram_bandwidth;
+    reference_values[BASELINE_REFRESH] = info.refresh_rate;
+    reference_values[BASELINE_VI_PER_SEC] = (float)measurements.vi_interrupts_per_sec;
+    reference_values[BASELINE_FPS] = measurements.actual_fps;
 
-    draw_label_value(disp, 20, y, "L1 Instruction", "16 KB");
-    y += line_height;
-    
-    y += 3;
-    
-    // Frequency range
-    graphics_draw_text(disp, 15, y, "Frequency Range");
-    y += line_height + 2;
-    
-    snprintf(buffer, sizeof(buffer), "%.2f MHz", measurements.cpu_freq_min);
-    draw_label_value(disp, 20, y, "Min", buffer);
-    y += line_height;
-    
-    snprintf(buffer, sizeof(buffer), "%.2f MHz", measurements.cpu_freq_max);
-    draw_label_value(disp, 20, y, "Max", buffer);
-    y += line_height;
+    for (int m = 0; m < BASELINE_METRIC_COUNT; m++) {
+        reference_checks[m] = baseline_check(&reference->refs[m], reference_values[m]);
+    }
+}
+
+// Take the render-side snapshot (called every rendered frame)
+void update_measurements(void) {
+    measurements_poll();
+    measurements_snapshot(&measurements);
+
+    irq_stats_update();
+    measurements.vi_interrupts_per_sec = irq_stats_get(IRQ_VI)->per_sec;
+
+    update_video_info();
+    check_reference();
+    record_history();
+    telemetry_record(&measurements, irq_stats_total_load());
 }
 
-// Draw Memory tab
-void draw_memory_tab(display_context_t disp, uint32_t memory_mb) {
+// Draw RCP interrupt load page
+void draw_rcp_interrupts(display_context_t disp) {
     int y = 50;
     int line_height = 11;
     char buffer[128];
     
-    // General section
-    graphics_draw_text(disp, 15, y, "General");
-    y += line_height + 2;
-    
-    draw_label_value(disp, 20, y, "Type", "Rambus DRAM");
-    y += line_height;
-    
-    snprintf(buffer, sizeof(buffer), "%u MB", memory_mb);
-    draw_label_value(disp, 20, y, "Size", buffer);
-    y += line_height;
-    
-    const char* expansion = (memory_mb == 8) ? "Yes" : "No";
-    draw_label_value(disp, 20, y, "Expansion Pak", expansion);
-    y += line_height;
-    
-    y += 3;
-    
-    // Timings section - REAL-TIME
-    graphics_draw_text(disp, 15, y, "Timings (Real-Time)");
+    ui_draw_text(disp, 15, y, "MI Interrupts (Real-Time)");
     y += line_height + 2;
     
-    draw_label_value(disp, 20, y, "Frequency", "250 MHz");
-    y += line_height;
-    
-    snprintf(buffer, sizeof(buffer), "%u MB/s", measurements.rdram_bandwidth);
-    draw_label_value(disp, 20, y, "Bandwidth", buffer);
-    y += line_height;
-    
-    draw_label_value(disp, 20, y, "Bus Width", "9-bit");
-    y += line_height;
-    
-    draw_label_value(disp, 20, y, "Theoretical Max", "562 MB/s");
-    y += line_height;
+    ui_draw_text(disp, 20, y, "Source   Rate/s  CPU us/s   Load");
+    y += line_height;
+    
+    for (int i = 0; i < IRQ_SOURCE_COUNT; i++) {
+        const IrqSourceStats *stats = irq_stats_get((IrqSource)i);
+        char value[FMT_MAX];
+        char *p = fmt_pad(buffer, irq_source_names[i], 6);
+        fmt_u32(value, stats->per_sec);
+        p = fmt_rjust(p, value, 9);
+        fmt_u32(value, stats->handler_us);
+        p = fmt_rjust(p, value, 10);
+        fmt_float(value, stats->load_percent, 2);
+        p = fmt_rjust(p, value, 7);
+        fmt_str(p, "%");
+        ui_draw_field(disp, 20, y, buffer);
+        y += line_height;
+    }
     
     y += 3;
     
-    // Physical Memory Map
-    graphics_draw_text(disp, 15, y, "Physical Memory");
+    ui_draw_text(disp, 15, y, "Frame Impact");
     y += line_height + 2;
     
-    draw_label_value(disp, 20, y, "Base RDRAM", "0x00000000-0x003FFFFF");
+    fmt_str(fmt_float(buffer, irq_stats_total_load(), 2), " %");
+    draw_label_value(disp, 20, y, "Handler CPU Time", buffer);
     y += line_height;
     
-    if (memory_mb == 8) {
-        draw_label_value(disp, 20, y, "Expansion", "0x00400000-0x007FFFFF");
-        y += line_height;
-    }
-    
-    draw_label_value(disp, 20, y, "MMIO Start", "0x04000000");
+    fmt_u32(buffer, measurements.vi_interrupts_per_sec);
+    draw_label_value(disp, 20, y, "VI Interrupts/s", buffer);
     y += line_height;
 }
 
 // Draw RCP tab
-void draw_rcp_tab(display_context_t disp, uint32_t rcp_version) {
-    int y = 50;
-    int line_height = 11;
-    char buffer[128];
-    
-    // RCP General
-    graphics_draw_text(disp, 15, y, "Reality Co-Processor");
-    y += line_height + 2;
-    
-    snprintf(buffer, sizeof(buffer), "0x%08X", rcp_version);
-    draw_label_value(disp, 20, y, "Version", buffer);
-    y += line_height;
-    
-    draw_label_value(disp, 20, y, "Clock", "62.5 MHz");
-    y += line_height;
-    
-    y += 3;
-    
-    // RSP Section
-    graphics_draw_text(disp, 15, y, "RSP (Reality Signal Processor)");
-    y += line_height + 2;
-    
-    draw_label_value(disp, 20, y, "Type", "Vector Processor");
-    y += line_height;
-    
-    draw_label_value(disp, 20, y, "Clock", "62.5 MHz");
-    y += line_height;
-    
-    draw_label_value(disp, 20, y, "DMEM", "4 KBytes");
-    y += line_height;
-    
-    draw_label_value(disp, 20, y, "IMEM", "4 KBytes");
-    y += line_height;
-    
-    draw_label_value(disp, 20, y, "Vector Unit", "8 x 128-bit regs");
-    y += line_height;
-    
-    y += 3;
-    
-    // RDP Section
-    graphics_draw_text(disp, 15, y, "RDP (Reality Display Processor)");
-    y += line_height + 2;
-    
-    draw_label_value(disp, 20, y, "Type", "Rasterizer");
-    y += line_height;
-    
-    draw_label_value(disp, 20, y, "Clock", "62.5 MHz");
-    y += line_height;
-    
-    draw_label_value(disp, 20, y, "TMEM", "4 KBytes");
-    y += line_height;
-    
-    draw_label_value(disp, 20, y, "Fill Rate", "~100 Mpixels/s");
-    y += line_height;
-    
-    draw_label_value(disp, 20, y, "Texture Formats", "Multiple");
-    y += line_height;
+void draw_rcp_tab(display_context_t disp, int page) {
+    if (page == 1) {
+        draw_rcp_interrupts(disp);
+    } else {
+        layout_draw(disp, &rcp_layout);
+    }
 }
 
-// Draw Video tab
-void draw_video_tab(display_context_t disp) {
-    int y = 50;
-    int line_height = 11;
-    char buffer[128];
-    
-    // Video Interface
-    graphics_draw_text(disp, 15, y, "Video Interface");
-    y += line_height + 2;
-    
-    snprintf(buffer, sizeof(buffer), "%s", get_tv_type_string());
-    draw_label_value(disp, 20, y, "TV System", buffer);
-    y += line_height;
-    
-    snprintf(buffer, sizeof(buffer), "%.1f Hz", get_tv_refresh_rate());
-    draw_label_value(disp, 20, y, "Refresh Rate", buffer);
-    y += line_height;
-    
+// Draw the reference check page of the CPU tab: every checked metric
+// against the entry selected for this console, worst verdict last
+void draw_reference_check(display_context_t disp) {
+    int y = UI_CONTENT_Y;
+    char buffer[64];
+    char value[FMT_MAX];
+
+    ui_draw_text(disp, 15, y, "Reference");
+    y += UI_LINE_HEIGHT + 2;
+    draw_label_value(disp, 20, y, "Profile", reference->name);
+    y += UI_LINE_HEIGHT;
+    char *p = fmt_str(fmt_str(buffer, info.tv_type), ", ");
+    p = fmt_str(fmt_u32(p, info.memory_mb), " MB, RCP ");
+    fmt_hex32(p, info.rcp_version);
+    draw_label_value(disp, 20, y, "Console", buffer);
+    y += UI_LINE_HEIGHT + 3;
+
+    ui_draw_text(disp, 15, y, "Checks (Real-Time)");
+    y += UI_LINE_HEIGHT + 2;
+    p = fmt_pad(buffer, "Metric", 10);
+    p = fmt_rjust(p, "Value", 7);
+    p = fmt_rjust(p, "Ref", 7);
+    p = fmt_rjust(p, "Dev", 7);
+    fmt_str(p, " Check");
+    ui_draw_text(disp, 20, y, buffer);
+    y += UI_LINE_HEIGHT;
+
+    BaselineVerdict worst = BASELINE_UNCHECKED;
+    for (int m = 0; m < BASELINE_METRIC_COUNT; m++) {
+        const BaselineCheck *check = &reference_checks[m];
+        int decimals = reference_decimals[m];
+
+        p = fmt_pad(buffer, baseline_metric_names[m], 10);
+        fmt_float(value, reference_values[m], decimals);
+        p = fmt_rjust(p, value, 7);
+        fmt_float(value, reference->refs[m].expected, decimals);
+        p = fmt_rjust(p, value, 7);
+        p = layout_fmt_deviation(p, check);
+        fmt_str(fmt_str(p, " "), baseline_verdict_names[check->verdict]);
+
+        ui_set_color(layout_verdict_color(check->verdict), UI_COLOR_BACKGROUND);
+        ui_draw_field(disp, 20, y, buffer);
+        y += UI_LINE_HEIGHT;
+
+        if (check->verdict != BASELINE_UNCHECKED &&
+            (worst == BASELINE_UNCHECKED || check->verdict > worst)) {
+            worst = check->verdict;
+        }
+    }
+    ui_set_color(UI_COLOR_TEXT, UI_COLOR_BACKGROUND);
+
     y += 3;
+    ui_draw_text(disp, 15, y, "Result");
+    y += UI_LINE_HEIGHT + 2;
+    p = fmt_str(fmt_pad(buffer, "Overall", 20), " : ");
+    ui_draw_text(disp, 20, y, buffer);
+    ui_set_color(layout_verdict_color(worst), UI_COLOR_BACKGROUND);
+    ui_draw_field(disp, 20 + (int)(p - buffer) * 8, y, baseline_verdict_names[worst]);
+    ui_set_color(UI_COLOR_TEXT, UI_COLOR_BACKGROUND);
+}
+
+// Draw Bench tab
+void draw_bench_tab(display_context_t disp, int bench, int page) {
+    const Benchmark *b = benchmarks[bench];
+    char buffer[64];
+    
+    snprintf(buffer, sizeof(buffer), "%s  (%d/%d)", b->name, bench + 1, BENCH_COUNT);
+    ui_draw_text(disp, 15, UI_CONTENT_Y, buffer);
+    
+    if (page < b->pages) {
+        b->draw(disp, UI_CONTENT_Y + UI_LINE_HEIGHT + 2, page);
+    } else {
+        results_draw_trend(disp, UI_CONTENT_Y + UI_LINE_HEIGHT + 2, bench, b);
+    }
+}
+
+int main(void) {
+    // Interrupt accounting exit probes go in before any other handler
+    irq_stats_init_tail();
     
-    // Current Settings
-    graphics_draw_text(disp, 15, y, "Current Mode");
-    y += line_height + 2;
-    
-    draw_label_value(disp, 20, y, "Resolution", "320 x 240");
-    y += line_height;
+    // Initialize display (depth selectable on the Setup tab)
+    ui_display_init();
     
-    draw_label_value(disp, 20, y, "Color Depth", "32-bit RGBA");
-    y += line_height;
+    // Initialize RDP command queue (benchmarks and the RDP renderer)
+    rdpq_init();
+    ui_init();
     
-    draw_label_value(disp, 20, y, "Pixel Format", "RGBA 8888");
-    y += line_height;
+    // Initialize controller
+    controller_init();
     
-    y += 3;
+    // Timeline SP/DP callbacks, inside the interrupt accounting probes
+    timeline_init();
     
-    // Real-time measurements
-    graphics_draw_text(disp, 15, y, "Real-Time Status");
-    y += line_height + 2;
+    // Timer-driven sampling, at its own rate (Setup tab)
+    measurements_init();
     
-    snprintf(buffer, sizeof(buffer), "%u", measurements.current_scanline);
-    draw_label_value(disp, 20, y, "Current Scanline", buffer);
-    y += line_height;
+    // Interrupt accounting entry probes run ahead of all other handlers
+    irq_stats_init_head();
     
-    snprintf(buffer, sizeof(buffer), "%.1f fps", measurements.actual_fps);
-    draw_label_value(disp, 20, y, "Actual FPS", buffer);
-    y += line_height;
+    profiler_init();
     
-    snprintf(buffer, sizeof(buffer), "%u", measurements.frames_counted);
-    draw_label_value(disp, 20, y, "Frame Count", buffer);
-    y += line_height;
-}
-
-int main(void) {
-    // Initialize display
-    display_init(RESOLUTION_320x240, DEPTH_32_BPP, 2, GAMMA_NONE, ANTIALIAS_RESAMPLE);
+    // Debug channel for the telemetry stream (off until enabled in Setup)
+    telemetry_init();
     
-    // Initialize controller
-    controller_init();
+    // Saved benchmark results from earlier sessions
+    results_init();
+    compare_init(benchmarks, BENCH_COUNT);
     
     // Get static system information
-    uint32_t prid = read_c0_prid();
-    uint32_t memory_mb = detect_memory_size();
-    uint32_t rcp_version = get_rcp_version();
-    
-    // Initialize measurements
-    measurements.cpu_freq_current = 93.75f;
-    measurements.cpu_freq_min = 93.75f;
-    measurements.cpu_freq_max = 93.75f;
-    measurements.frames_counted = 0;
-    measurements.rdram_bandwidth = 500; // Initial estimate
-    measurements.actual_fps = get_tv_refresh_rate(); // Initialize to expected refresh rate
+    init_info();
+    history_init(&history);
+    graph_init();
     
     Tab current_tab = TAB_CPU;
+    int tab_page[TAB_COUNT] = {0};
+    int bench_index = 0;
     
     while(1) {
-        // Update all real-time measurements
-        update_measurements();
+        timeline_frame_mark();
+        profiler_frame();
+        telemetry_trace();
         
         // Scan for controller input
+        profiler_mark(PROF_INPUT);
         controller_scan();
         struct controller_data keys = get_keys_down();
         
@@ -541,51 +545,157 @@ int main(void) {
             current_tab = (Tab)((current_tab + 1) % TAB_COUNT);
         }
         
+        // Benchmark selection and execution
+        if (current_tab == TAB_BENCH) {
+            if (keys.c[0].up) {
+                bench_index = (bench_index - 1 + BENCH_COUNT) % BENCH_COUNT;
+                tab_page[TAB_BENCH] = 0;
+            }
+            if (keys.c[0].down) {
+                bench_index = (bench_index + 1) % BENCH_COUNT;
+                tab_page[TAB_BENCH] = 0;
+            }
+            if (keys.c[0].A) {
+                benchmarks[bench_index]->run();
+                results_add(bench_index, benchmarks[bench_index]->score(), measurements.frames_counted);
+                ui_invalidate();
+                profiler_skip_frame();
+            }
+        }
+        
+        if (current_tab == TAB_LIVE && tab_page[TAB_LIVE] == 2 && keys.c[0].A) {
+            profiler_reset_worst();
+        }
+        
+        if (current_tab == TAB_SETUP && tab_page[TAB_SETUP] == 0) {
+            settings_input(&keys);
+        }
+        if (current_tab == TAB_SETUP && tab_page[TAB_SETUP] == 2) {
+            compare_input(&keys);
+        }
+        
+        // A running A/B comparison takes one benchmark per frame
+        if (compare_step()) {
+            ui_invalidate();
+            profiler_skip_frame();
+        }
+        
+        // Page navigation within the current tab
+        int pages = tab_page_count(current_tab, bench_index);
+        if (keys.c[0].left) {
+            tab_page[current_tab] = (tab_page[current_tab] - 1 + pages) % pages;
+        }
+        if (keys.c[0].right) {
+            tab_page[current_tab] = (tab_page[current_tab] + 1) % pages;
+        }
+        
         // Exit on Start
         if(keys.c[0].start) {
             break;
         }
+        profiler_mark(PROF_OTHER);
+        
+        // Apply a new display mode between frames. display_init registers a
+        // fresh VI handler, so the accounting entry probes go back in front.
+        if (ui_display_pending()) {
+            ui_display_init();
+            irq_stats_init_head();
+            profiler_skip_frame();
+        }
+        
+        // Get a free framebuffer
+        profiler_mark(PROF_ACQUIRE);
+        display_context_t disp = ui_acquire();
+        
+        // Snapshot the sampler's latest values for this frame
+        profiler_mark(PROF_UPDATE);
+        timeline_begin(TL_PHASE_UPDATE);
+        update_measurements();
+        timeline_end(TL_PHASE_UPDATE);
+        
+        timeline_begin(TL_PHASE_DRAW);
         
-        // Lock display
-        display_context_t disp = 0;
-        while(!(disp = display_lock()));
+        uint32_t layout = (current_tab << 16) | (tab_page[current_tab] << 8) | bench_index;
+        
+        // The timeline is redrawn from scratch every frame
+        if (current_tab == TAB_LIVE) {
+            layout |= UI_LAYOUT_DYNAMIC;
+        }
+        ui_begin(disp, layout);
         
         // Clear screen with dark background
-        graphics_fill_screen(disp, 0x1A1A2EFF);
+        profiler_mark(PROF_CLEAR);
+        ui_fill_screen(disp, UI_COLOR_BACKGROUND);
         
         // Draw title bar
-        graphics_draw_box(disp, 0, 0, 320, 25, 0x2D2D44FF);
-        graphics_draw_text(disp, 10, 8, "N64-Z - Nintendo 64 System Info");
+        profiler_mark(PROF_CHROME);
+        ui_draw_box(disp, 0, 0, 320, 25, UI_COLOR_BAR);
+        ui_set_color(UI_COLOR_TEXT, UI_COLOR_BAR);
+        ui_draw_text(disp, 10, 8, "N64-Z - Nintendo 64 System Info");
         
-        // Draw tabs
+        // Draw tabs (sized to their names so that all of them fit)
+        int tab_x = 4;
         for (int i = 0; i < TAB_COUNT; i++) {
-            int tab_x = 10 + (i * 70);
             int tab_y = 28;
+            int tab_w = strlen(tab_names[i]) * 8 + 6;
             
             if (i == current_tab) {
                 // Active tab
-                graphics_draw_box(disp, tab_x, tab_y, 65, 18, 0x4A4A6AFF);
-                graphics_draw_text(disp, tab_x + 5, tab_y + 5, tab_names[i]);
+                ui_draw_box(disp, tab_x, tab_y, tab_w, 18, UI_COLOR_HIGHLIGHT);
+                ui_set_color(UI_COLOR_TEXT, UI_COLOR_HIGHLIGHT);
+                ui_draw_text(disp, tab_x + 3, tab_y + 5, tab_names[i]);
             } else {
                 // Inactive tab
-                graphics_draw_box(disp, tab_x, tab_y, 65, 18, 0x2D2D44FF);
-                graphics_draw_text(disp, tab_x + 5, tab_y + 5, tab_names[i]);
+                ui_draw_box(disp, tab_x, tab_y, tab_w, 18, UI_COLOR_BAR);
+                ui_set_color(UI_COLOR_TEXT, UI_COLOR_BAR);
+                ui_draw_text(disp, tab_x + 3, tab_y + 5, tab_names[i]);
             }
+            tab_x += tab_w + 2;
         }
+        ui_set_color(UI_COLOR_TEXT, UI_COLOR_BACKGROUND);
         
         // Draw current tab content
+        profiler_mark(PROF_TAB);
+        profiler_tag(current_tab);
         switch(current_tab) {
             case TAB_CPU:
-                draw_cpu_tab(disp, prid);
+                if (tab_page[TAB_CPU] == 1) {
+                    draw_reference_check(disp);
+                } else {
+                    layout_draw(disp, &cpu_layout);
+                }
                 break;
             case TAB_MEMORY:
-                draw_memory_tab(disp, memory_mb);
+                layout_draw(disp, &memory_layout);
                 break;
             case TAB_RCP:
-                draw_rcp_tab(disp, rcp_version);
+                draw_rcp_tab(disp, tab_page[TAB_RCP]);
                 break;
             case TAB_VIDEO:
-                draw_video_tab(disp);
+                layout_draw(disp, tab_page[TAB_VIDEO] == 1 ? &video_status_layout : &video_layout);
+                break;
+            case TAB_LIVE:
+                if (tab_page[TAB_LIVE] == 0) {
+                    timeline_draw(disp, 50);
+                } else if (tab_page[TAB_LIVE] == 1) {
+                    profiler_draw_budget(disp, 50);
+                } else if (tab_page[TAB_LIVE] == 2) {
+                    profiler_draw_worst(disp, 50, tab_names);
+                } else if (tab_page[TAB_LIVE] == 3) {
+                    graph_draw_page(disp, 50, &history);
+                } else {
+                    layout_draw(disp, &metric_layout);
+                }
+                break;
+            case TAB_BENCH:
+                draw_bench_tab(disp, bench_index, tab_page[TAB_BENCH]);
+                break;
+            case TAB_SETUP:
+                if (tab_page[TAB_SETUP] == 2) {
+                    compare_draw(disp, 50);
+                } else {
+                    settings_draw(disp, 50, tab_page[TAB_SETUP]);
+                }
                 break;
             case TAB_COUNT:
                 // Not a real tab, just for counting
@@ -593,11 +703,37 @@ int main(void) {
         }
         
         // Draw status bar
-        graphics_draw_box(disp, 0, 225, 320, 15, 0x2D2D44FF);
-        graphics_draw_text(disp, 10, 229, "L/R: Switch Tab | START: Exit");
+        profiler_mark(PROF_CHROME);
+        ui_draw_box(disp, 0, 225, 320, 15, UI_COLOR_BAR);
+        ui_set_color(UI_COLOR_TEXT, UI_COLOR_BAR);
+        if (current_tab == TAB_BENCH) {
+            ui_draw_text(disp, 10, 229, "A: Run | D-Pad: Select/Page");
+        } else if (current_tab == TAB_SETUP && tab_page[TAB_SETUP] != 1) {
+            ui_draw_text(disp, 10, 229, "A: Change | D-Pad: Select/Page");
+        } else if (pages > 1) {
+            ui_draw_text(disp, 10, 229, "L/R: Switch Tab | D-Pad: Page");
+        } else {
+            ui_draw_text(disp, 10, 229, "L/R: Switch Tab | START: Exit");
+        }
+        ui_set_color(UI_COLOR_TEXT, UI_COLOR_BACKGROUND);
+        
+        profiler_mark(PROF_FLUSH);
+        ui_end();
+        profiler_draw_hud(disp);
+        timeline_end(TL_PHASE_DRAW);
         
         // Show display
-        display_show(disp);
+        profiler_mark(PROF_SHOW);
+        timeline_begin(TL_PHASE_SHOW);
+        ui_show(disp);
+        timeline_end(TL_PHASE_SHOW);
+        measurements_frame_rendered();
+        
+        // Stream queued telemetry within its per-frame byte budget, and
+        // trickle queued result blocks out to the EEPROM
+        profiler_mark(PROF_OTHER);
+        telemetry_pump();
+        results_pump();
     }
     
     return 0;
@@ -0,0 +1,261 @@
+#include <libdragon.h>
+#include <stdint.h>
+
+#include "measurements.h"
+#include "hw.h"
+
+const char* measure_rate_names[MEASURE_RATE_COUNT] = {
+    "60 Hz",
+    "120 Hz",
+    "240 Hz"
+};
+
+static const uint32_t measure_rate_hz[MEASURE_RATE_COUNT] = { 60, 120, 240 };
+
+// Written by the sampling timer, and by measurements_poll with interrupts
+// disabled; read through measurements_snapshot
+static SystemMeasurements measurements = {0};
+
+static MeasureRate rate = MEASURE_RATE_240;
+static timer_link_t *sample_timer = NULL;
+static volatile uint32_t vi_frames = 0;
+static volatile uint32_t vi_edge_count = 0;     // COUNT at the latest vertical interrupt
+static volatile uint32_t rendered_frames = 0;
+
+float get_tv_refresh_rate(void) {
+    switch(get_tv_type()) {
+        case TV_PAL: return 50.0f;
+        case TV_NTSC: return 60.0f;
+        case TV_MPAL: return 60.0f;
+        default: return 60.0f;
+    }
+}
+
+// CPU frequency over the whole VI frames since the previous call. Both ends
+// are COUNT values taken in the VI handler, so the window is exactly
+// frames_elapsed refresh periods whatever the phase of the sampling timer.
+static void sample_cpu_frequency(void) {
+    static uint32_t last_count = 0;
+    static uint32_t last_frame = 0;
+    static int started = 0;
+
+    // The timer interrupt runs with interrupts disabled, so the pair is consistent
+    uint32_t current_count = vi_edge_count;
+    uint32_t frames_elapsed = measurements.frames_counted - last_frame;
+
+    if (started && frames_elapsed > 0) {
+        uint32_t count_delta = current_count - last_count;
+        uint64_t cpu_cycles = (uint64_t)count_delta * 2; // COUNT is half CPU speed
+
+        float frame_rate = get_tv_refresh_rate();
+        measurements.cpu_freq_current = ((float)cpu_cycles / (float)frames_elapsed) * frame_rate / 1000000.0f;
+        measurements.cpu_cycles_per_frame = (uint32_t)(cpu_cycles / frames_elapsed);
+    }
+
+    last_count = current_count;
+    last_frame = measurements.frames_counted;
+    started = 1;
+}
+
+// Measure memory bandwidth (approximate via timing). Runs from the main
+// loop, so an interrupt may land inside the copy: it is timed in chunks and
+// the fastest chunk counts.
+static void sample_bandwidth(void) {
+    // Allocate dedicated uncached buffers to avoid stomping code/data
+    // Use uncached memory (KSEG1: 0xA0000000) to avoid cache effects
+    #define BW_TEST_SIZE 4096  // 4KB test
+    #define BW_CHUNK_SIZE 1024
+    static uint32_t src_buffer[BW_TEST_SIZE / 4] __attribute__((aligned(16)));
+    static uint32_t dst_buffer[BW_TEST_SIZE / 4] __attribute__((aligned(16)));
+
+    // Use uncached addresses to bypass cache
+    uintptr_t src_phys = ((uintptr_t)src_buffer & 0x1FFFFFFF) | 0xA0000000;
+    uintptr_t dst_phys = ((uintptr_t)dst_buffer & 0x1FFFFFFF) | 0xA0000000;
+    volatile uint32_t *src = (volatile uint32_t *)src_phys;
+    volatile uint32_t *dst = (volatile uint32_t *)dst_phys;
+
+    // Initialize source buffer
+    for (int i = 0; i < BW_TEST_SIZE / 4; i++) {
+        src[i] = i;
+    }
+
+    // Flush data cache to ensure clean test
+    data_cache_hit_writeback_invalidate(src_buffer, BW_TEST_SIZE);
+    data_cache_hit_writeback_invalidate(dst_buffer, BW_TEST_SIZE);
+
+    // Copy 4KB using uncached access (tests actual RDRAM speed)
+    uint32_t best = UINT32_MAX;
+    for (int chunk = 0; chunk < BW_TEST_SIZE / BW_CHUNK_SIZE; chunk++) {
+        int first = chunk * BW_CHUNK_SIZE / 4;
+        uint32_t count_start = read_c0_count();
+
+        for (int i = first; i < first + BW_CHUNK_SIZE / 4; i++) {
+            dst[i] = src[i];
+        }
+
+        uint32_t ticks = read_c0_count() - count_start;
+        if (ticks < best) best = ticks;
+    }
+    uint64_t cycles = (uint64_t)best * 2;
+
+    // Calculate bandwidth: bytes / (cycles / CPU_freq). A single 32-bit
+    // store, so the timer never sees it half written.
+    float cpu_freq = measurements.cpu_freq_current;
+    if (cpu_freq > 0 && cycles > 0) {
+        float time_seconds = (float)cycles / (cpu_freq * 1000000.0f);
+        float bandwidth_mbps = (BW_CHUNK_SIZE / time_seconds) / (1024.0f * 1024.0f);
+        measurements.rdram_bandwidth = (uint32_t)bandwidth_mbps;
+    }
+    #undef BW_CHUNK_SIZE
+    #undef BW_TEST_SIZE
+}
+
+// Measure current video scanline
+static void sample_scanline(void) {
+    volatile uint32_t *vi_current = (uint32_t *)VI_CURRENT_REG;
+    measurements.current_scanline = (*vi_current >> 1) & 0x3FF;
+}
+
+// Rendering rate over the window since the previous call
+static void sample_fps(void) {
+    static uint32_t last_rendered = 0;
+    static uint32_t last_count = 0;
+    static int started = 0;
+
+    uint32_t current_count = read_c0_count();
+    uint32_t rendered = rendered_frames;
+
+    if (started && measurements.cpu_freq_current > 0) {
+        uint64_t cpu_cycles = (uint64_t)(current_count - last_count) * 2;
+        float time_seconds = (float)cpu_cycles / (measurements.cpu_freq_current * 1000000.0f);
+        measurements.actual_fps = (rendered - last_rendered) / time_seconds;
+    }
+
+    last_rendered = rendered;
+    last_count = current_count;
+    started = 1;
+}
+
+typedef enum {
+    SAMPLE_TIMER = 0,
+    SAMPLE_MAIN
+} SampleContext;
+
+// Sampler of every registered metric, how often and where it runs
+typedef struct {
+    void (*sample)(void);
+    uint32_t period;        // VI frames, 0 for every sample
+    SampleContext context;
+} Sampler;
+
+static const Sampler samplers[METRIC_COUNT] = {
+#define SAMPLER(id, type, field, name, unit, sample, period, format, stats, history, color, export, \
+                index, scale, context) [METRIC_##id] = { sample, period, SAMPLE_##context },
+    METRIC_TABLE(SAMPLER)
+#undef SAMPLER
+};
+
+static uint32_t last_sampled[METRIC_COUNT];
+
+#define TRACK_RANGE(field)                                                          \
+    if (measurements.field##_min == 0 || measurements.field < measurements.field##_min) { \
+        measurements.field##_min = measurements.field;                              \
+    }                                                                               \
+    if (measurements.field > measurements.field##_max) {                            \
+        measurements.field##_max = measurements.field;                              \
+    }
+#define TRACK_NONE(field)
+
+// Run the samplers of one context that are due; returns a bit per metric sampled
+static uint32_t run_samplers(SampleContext context, uint32_t frames) {
+    uint32_t sampled = 0;
+
+    for (int i = 0; i < METRIC_COUNT; i++) {
+        const Sampler *sampler = &samplers[i];
+        if (sampler->context != context) {
+            continue;
+        }
+        if (sampler->period == 0 || frames - last_sampled[i] >= sampler->period) {
+            last_sampled[i] = frames;
+            sampler->sample();
+            sampled |= 1u << i;
+        }
+    }
+    return sampled;
+}
+
+// Ranges only follow values that were just sampled
+static void track_ranges(uint32_t sampled) {
+#define TRACK(id, type, field, name, unit, sample, period, format, stats, ...) \
+    if (sampled & (1u << METRIC_##id)) { TRACK_##stats(field) }
+    METRIC_TABLE(TRACK)
+#undef TRACK
+}
+
+// Timer interrupt: take one sample. The timed measurements run on their
+// registered VI frame period, so raising the rate only adds cheap register
+// reads.
+static void sample_callback(int ovfl) {
+    measurements.samples_taken++;
+    measurements.frames_counted = vi_frames;
+    measurements.last_count = read_c0_count();
+
+    track_ranges(run_samplers(SAMPLE_TIMER, measurements.frames_counted));
+}
+
+static void vi_callback(void) {
+    vi_edge_count = read_c0_count();
+    vi_frames++;
+}
+
+static void start_timer(void) {
+    if (sample_timer) {
+        delete_timer(sample_timer);
+    }
+    sample_timer = new_timer(TIMER_TICKS(1000000 / measure_rate_hz[rate]),
+                             TF_CONTINUOUS, sample_callback);
+}
+
+void measurements_init(void) {
+    measurements.cpu_freq_current = 93.75f;
+    measurements.cpu_freq_current_min = 93.75f;
+    measurements.cpu_freq_current_max = 93.75f;
+    measurements.rdram_bandwidth = 500; // Initial estimate
+    measurements.actual_fps = get_tv_refresh_rate(); // Initialize to expected refresh rate
+
+    register_VI_handler(vi_callback);
+    timer_init();
+    start_timer();
+}
+
+void measurements_set_rate(MeasureRate r) {
+    // The timer list is walked from the COMPARE interrupt
+    disable_interrupts();
+    rate = r;
+    start_timer();
+    enable_interrupts();
+}
+
+MeasureRate measurements_get_rate(void) {
+    return rate;
+}
+
+void measurements_poll(void) {
+    uint32_t sampled = run_samplers(SAMPLE_MAIN, vi_frames);
+
+    if (sampled) {
+        disable_interrupts();
+        track_ranges(sampled);
+        enable_interrupts();
+    }
+}
+
+void measurements_frame_rendered(void) {
+    rendered_frames++;
+}
+
+void measurements_snapshot(SystemMeasurements *out) {
+    disable_interrupts();
+    *out = measurements;
+    enable_interrupts();
+}
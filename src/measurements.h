@@ -0,0 +1,66 @@
+#ifndef MEASUREMENTS_H
+#define MEASUREMENTS_H
+
+#include <stdint.h>
+
+#include "metrics.h"
+
+#define MEASUREMENTS_RANGE_RANGE(type, field) type field##_min; type field##_max;
+#define MEASUREMENTS_RANGE_NONE(type, field)
+
+// Measurement structure for continuous monitoring
+typedef struct {
+    // Registered metrics (metrics.h), with their session range if kept
+#define MEASUREMENTS_FIELD(id, type, field, name, unit, sample, period, format, stats, ...) \
+    type field; MEASUREMENTS_RANGE_##stats(type, field)
+    METRIC_TABLE(MEASUREMENTS_FIELD)
+#undef MEASUREMENTS_FIELD
+
+    // CPU measurements
+    uint32_t cpu_cycles_per_frame;
+
+    // Memory measurements
+    uint32_t rdram_latency;    // cycles
+
+    // RCP measurements
+    float rsp_load_percent;
+    float rdp_load_percent;
+    uint32_t vi_interrupts_per_sec;
+
+    // Timing
+    uint32_t frames_counted;   // Vertical interrupts since start
+    uint32_t samples_taken;
+    uint32_t last_count;
+} SystemMeasurements;
+
+// Sampling rate. Samples are taken from a timer interrupt, independently
+// of how often the UI is rendered.
+typedef enum {
+    MEASURE_RATE_60 = 0,
+    MEASURE_RATE_120,
+    MEASURE_RATE_240,
+    MEASURE_RATE_COUNT
+} MeasureRate;
+
+extern const char* measure_rate_names[MEASURE_RATE_COUNT];
+
+// Starts the sampling timer and the VI frame counter
+void measurements_init(void);
+
+void measurements_set_rate(MeasureRate rate);
+MeasureRate measurements_get_rate(void);
+
+// Run the samplers registered for the main loop that are due (metrics.h),
+// called every rendered frame before the snapshot
+void measurements_poll(void);
+
+// Called once per rendered frame, for the FPS figure
+void measurements_frame_rendered(void);
+
+// Copy of the latest sample, taken with interrupts disabled so that every
+// field comes from the same sample
+void measurements_snapshot(SystemMeasurements *out);
+
+float get_tv_refresh_rate(void);
+
+#endif /* MEASUREMENTS_H */
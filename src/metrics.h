@@ -0,0 +1,45 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+// Registry of the sampled metrics, each declared once. METRIC_TABLE is an
+// X-macro: a consumer passes a macro that picks the columns it needs, so
+// the snapshot fields, the sampling schedule, the session ranges, history,
+// graphs, telemetry export and the Metrics page all expand from this list
+// at compile time. Tokens are only resolved where a column is used, so the
+// header has no dependencies and the host tests include it too.
+//
+//   id       METRIC_<id>, and HISTORY_<id> for metrics kept in history
+//   type     Field type in SystemMeasurements (float or uint32_t)
+//   field    SystemMeasurements member
+//   name     Display name
+//   unit     Display unit, appended to the formatted value
+//   sample   Sampler in measurements.c, run from the timer interrupt
+//   period   VI frames between samples; 0 runs it on every timer tick
+//   format   Layout formatter for the bare value
+//   stats    RANGE keeps <field>_min and <field>_max for the session, NONE not
+//   history  HIST keeps frame/second/minute history and a graph, NOHIST not
+//   color    Graph color
+//   export   EXPORT sends the value in telemetry records, NOEXPORT not
+//   index    Telemetry record field
+//   scale    Multiplier to the integer sent in the record
+//   context  TIMER runs the sampler in the timer interrupt, MAIN from the
+//            main loop (measurements_poll), for samplers too slow to run
+//            with interrupts masked
+#define METRIC_TABLE(X) \
+    X(CPU_MHZ,   float,    cpu_freq_current, "CPU MHz",   "MHz",  sample_cpu_frequency, 5,  layout_fmt_float2, \
+      RANGE, HIST, UI_COLOR_BLUE,   EXPORT, TELEMETRY_CPU_KHZ,   1000.0f, TIMER) \
+    X(BANDWIDTH, uint32_t, rdram_bandwidth,  "Bandwidth", "MB/s", sample_bandwidth,     30, layout_fmt_u32,    \
+      RANGE, HIST, UI_COLOR_GREEN,  EXPORT, TELEMETRY_BANDWIDTH, 1.0f,    MAIN) \
+    X(FPS,       float,    actual_fps,       "FPS",       "fps",  sample_fps,           60, layout_fmt_float1, \
+      RANGE, HIST, UI_COLOR_YELLOW, EXPORT, TELEMETRY_FPS_X100,  100.0f,  TIMER) \
+    X(SCANLINE,  uint32_t, current_scanline, "Scanline",  "",     sample_scanline,      0,  layout_fmt_u32,    \
+      NONE,  HIST, UI_COLOR_PURPLE, EXPORT, TELEMETRY_SCANLINE,  1.0f,    TIMER)
+
+typedef enum {
+#define METRIC_ID(id, ...) METRIC_##id,
+    METRIC_TABLE(METRIC_ID)
+#undef METRIC_ID
+    METRIC_COUNT
+} MetricId;
+
+#endif /* METRICS_H */
@@ -0,0 +1,267 @@
+#include <libdragon.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "profiler.h"
+#include "fmt.h"
+#include "hw.h"
+#include "measurements.h"
+#include "ui.h"
+
+// HUD geometry: a thin track under the title text, 2 px per percent of
+// the VI period, so frames up to 150% stay on screen
+#define HUD_X         10
+#define HUD_Y         19
+#define HUD_H         4
+#define HUD_WIDTH     300
+#define HUD_PX_PER_PCT 2
+
+const char* profiler_hud_names[PROF_HUD_COUNT] = {
+    "Off",
+    "On"
+};
+
+static const char* phase_names[PROF_PHASE_COUNT] = {
+    "Other",
+    "Input",
+    "Wait",
+    "Snapshot",
+    "Clear",
+    "Chrome",
+    "Tab",
+    "Flush",
+    "Show"
+};
+
+static const UiColor phase_colors[PROF_PHASE_COUNT] = {
+    UI_COLOR_TEXT,
+    UI_COLOR_PURPLE,
+    UI_COLOR_HIGHLIGHT,
+    UI_COLOR_YELLOW,
+    UI_COLOR_CYAN,
+    UI_COLOR_ORANGE,
+    UI_COLOR_GREEN,
+    UI_COLOR_BLUE,
+    UI_COLOR_RED
+};
+
+typedef struct {
+    uint32_t ticks[PROF_PHASE_COUNT];
+    uint32_t total;
+    int tag;
+} ProfFrame;
+
+static ProfFrame cur;
+static ProfFrame last;
+static ProfFrame worst[PROF_WORST];     // Sorted, longest first
+static int worst_count = 0;
+static float avg_ticks[PROF_PHASE_COUNT];
+static float avg_total = 0.0f;
+
+// Interval log of the running and the last complete frame
+static ProfSlice cur_slices[PROF_SLICES];
+static ProfSlice last_slices[PROF_SLICES];
+static int cur_slice_count = 0;
+static int last_slice_count = 0;
+static uint32_t last_start = 0;
+
+static ProfPhase phase = PROF_OTHER;
+static uint32_t phase_start = 0;
+static uint32_t frame_start = 0;
+static uint32_t period_ticks = 1;
+static int frames = 0;
+static int skip = 1;                    // The first frame has no start
+static ProfHud hud = PROF_HUD_OFF;
+
+void profiler_init(void) {
+    period_ticks = (uint32_t)(TICKS_PER_SECOND / get_tv_refresh_rate());
+    frame_start = phase_start = read_c0_count();
+}
+
+void profiler_mark(ProfPhase next) {
+    uint32_t now = read_c0_count();
+    cur.ticks[phase] += now - phase_start;
+    if (now != phase_start && cur_slice_count < PROF_SLICES) {
+        ProfSlice *s = &cur_slices[cur_slice_count++];
+        s->phase = phase;
+        s->start = phase_start;
+        s->ticks = now - phase_start;
+    }
+    phase_start = now;
+    phase = next;
+}
+
+static void worst_insert(const ProfFrame *f) {
+    if (worst_count == PROF_WORST && f->total <= worst[PROF_WORST - 1].total) {
+        return;
+    }
+
+    int i = (worst_count < PROF_WORST) ? worst_count++ : PROF_WORST - 1;
+    while (i > 0 && worst[i - 1].total < f->total) {
+        worst[i] = worst[i - 1];
+        i--;
+    }
+    worst[i] = *f;
+}
+
+void profiler_frame(void) {
+    profiler_mark(PROF_OTHER);
+    cur.total = phase_start - frame_start;
+
+    if (!skip) {
+        last = cur;
+        worst_insert(&cur);
+
+        memcpy(last_slices, cur_slices, cur_slice_count * sizeof(ProfSlice));
+        last_slice_count = cur_slice_count;
+        last_start = frame_start;
+
+        for (int p = 0; p < PROF_PHASE_COUNT; p++) {
+            if (frames == 0) {
+                avg_ticks[p] = cur.ticks[p];
+            } else {
+                avg_ticks[p] = avg_ticks[p] * 0.9f + cur.ticks[p] * 0.1f;
+            }
+        }
+        avg_total = frames == 0 ? cur.total : avg_total * 0.9f + cur.total * 0.1f;
+        frames++;
+    }
+
+    memset(&cur, 0, sizeof(cur));
+    cur_slice_count = 0;
+    frame_start = phase_start;
+    skip = 0;
+}
+
+void profiler_tag(int tag) {
+    cur.tag = tag;
+}
+
+void profiler_skip_frame(void) {
+    skip = 1;
+}
+
+void profiler_reset_worst(void) {
+    worst_count = 0;
+}
+
+int profiler_take_slices(ProfSlice *out, int max, uint32_t *frame_start, uint32_t *frame_ticks) {
+    int n = last_slice_count < max ? last_slice_count : max;
+    memcpy(out, last_slices, n * sizeof(ProfSlice));
+    *frame_start = last_start;
+    *frame_ticks = last.total;
+    last_slice_count = 0;
+    return n;
+}
+
+void profiler_set_hud(ProfHud h) {
+    hud = h;
+}
+
+ProfHud profiler_get_hud(void) {
+    return hud;
+}
+
+static float percent(float ticks) {
+    return ticks * 100.0f / period_ticks;
+}
+
+void profiler_draw_hud(display_context_t disp) {
+    if (hud == PROF_HUD_OFF) {
+        return;
+    }
+
+    // The whole track is repainted, so incremental frames stay clean
+    ui_draw_overlay(disp, HUD_X, HUD_Y, HUD_WIDTH, HUD_H, UI_COLOR_BACKGROUND);
+
+    if (frames == 0) {
+        return;
+    }
+
+    int x = HUD_X;
+    for (int p = 0; p < PROF_PHASE_COUNT && x < HUD_X + HUD_WIDTH; p++) {
+        int w = (int)((uint64_t)last.ticks[p] * 100 * HUD_PX_PER_PCT / period_ticks);
+        if (x + w > HUD_X + HUD_WIDTH) {
+            w = HUD_X + HUD_WIDTH - x;
+        }
+        if (w > 0) {
+            ui_draw_overlay(disp, x, HUD_Y, w, HUD_H, phase_colors[p]);
+        }
+        x += w;
+    }
+
+    // 100% of the VI period
+    ui_draw_overlay(disp, HUD_X + 100 * HUD_PX_PER_PCT, HUD_Y - 1, 1, HUD_H + 2, UI_COLOR_TEXT);
+}
+
+// "12.3 / 45.6 %"
+static void fmt_avg_last(char *dst, float avg, float last) {
+    dst = fmt_str(fmt_float(dst, avg, 1), " / ");
+    fmt_str(fmt_float(dst, last, 1), " %");
+}
+
+void profiler_draw_budget(display_context_t disp, int y) {
+    char buffer[64];
+    int line_height = UI_LINE_HEIGHT;
+
+    ui_draw_text(disp, 15, y, "Frame Budget (Avg / Last, % of VI)");
+    y += line_height + 2;
+
+    if (frames == 0) {
+        return;
+    }
+
+    for (int p = 0; p < PROF_PHASE_COUNT; p++) {
+        ui_draw_box(disp, 15, y, 6, 8, phase_colors[p]);
+        fmt_avg_last(buffer, percent(avg_ticks[p]), percent(last.ticks[p]));
+        draw_label_value(disp, 25, y, phase_names[p], buffer);
+        y += line_height;
+    }
+
+    fmt_avg_last(buffer, percent(avg_total), percent(last.total));
+    draw_label_value(disp, 25, y, "Frame Total", buffer);
+    y += line_height;
+
+    // Time not spent waiting for a buffer is the real cost of a frame
+    float busy = avg_total - avg_ticks[PROF_ACQUIRE];
+    char *p = fmt_str(fmt_float(buffer, busy * 1000.0f / TICKS_PER_SECOND, 2), " ms (");
+    fmt_str(fmt_float(p, percent(busy), 0), " %)");
+    draw_label_value(disp, 25, y, "Busy per Frame", buffer);
+    y += line_height;
+}
+
+void profiler_draw_worst(display_context_t disp, int y, const char* const *tag_names) {
+    char buffer[64];
+    int line_height = UI_LINE_HEIGHT;
+
+    ui_draw_text(disp, 15, y, "Worst Frames (A: Reset)");
+    y += line_height + 2;
+
+    ui_draw_text(disp, 20, y, "   ms  % VI  Tab     Top phase");
+    y += line_height;
+
+    for (int i = 0; i < worst_count; i++) {
+        const ProfFrame *f = &worst[i];
+
+        // Heaviest phase apart from waiting, which only absorbs slack
+        int top = PROF_OTHER;
+        for (int p = 1; p < PROF_PHASE_COUNT; p++) {
+            if (p != PROF_ACQUIRE && f->ticks[p] > f->ticks[top]) {
+                top = p;
+            }
+        }
+
+        char value[FMT_MAX];
+        fmt_float(value, (float)f->total * 1000.0f / TICKS_PER_SECOND, 2);
+        char *p = fmt_str(fmt_rjust(buffer, value, 5), "  ");
+        fmt_float(value, percent(f->total), 0);
+        p = fmt_str(fmt_rjust(p, value, 4), "  ");
+        p = fmt_str(fmt_pad(p, tag_names[f->tag], 6), "  ");
+        p = fmt_str(fmt_pad(p, phase_names[top], 8), " ");
+        fmt_float(value, percent(f->ticks[top]), 0);
+        fmt_str(fmt_rjust(p, value, 3), "%");
+        ui_draw_box(disp, 15, y, 3, 8, phase_colors[top]);
+        ui_draw_text(disp, 20, y, buffer);
+        y += line_height;
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <libdragon.h>
+#include <stdint.h>
+
+// Main loop phases. Each mark closes the running phase and opens the next,
+// so a frame costs one COUNT read per boundary.
+typedef enum {
+    PROF_OTHER = 0,     // Anything between marks (navigation, mode changes)
+    PROF_INPUT,         // controller_scan and key handling
+    PROF_ACQUIRE,       // Waiting for a framebuffer
+    PROF_UPDATE,        // Measurement snapshot
+    PROF_CLEAR,         // ui_fill_screen
+    PROF_CHROME,        // Title bar, tabs, status bar
+    PROF_TAB,           // draw_*_tab
+    PROF_FLUSH,         // ui_end: background blit, batched text
+    PROF_SHOW,          // ui_show
+    PROF_PHASE_COUNT
+} ProfPhase;
+
+typedef enum {
+    PROF_HUD_OFF = 0,
+    PROF_HUD_ON,
+    PROF_HUD_COUNT
+} ProfHud;
+
+extern const char* profiler_hud_names[PROF_HUD_COUNT];
+
+#define PROF_WORST 8    // Worst frames kept since the last reset
+#define PROF_SLICES 24  // Phase intervals kept per frame for tracing
+
+// One uninterrupted stretch of a phase, timestamped with COUNT
+typedef struct {
+    uint8_t phase;
+    uint32_t start;
+    uint32_t ticks;
+} ProfSlice;
+
+void profiler_init(void);
+
+// Close the previous frame and start a new one in PROF_OTHER
+void profiler_frame(void);
+void profiler_mark(ProfPhase phase);
+
+// Tag the current frame (the active tab) for the worst-frame history
+void profiler_tag(int tag);
+
+// Leave the current frame out of the statistics (benchmarks, mode changes)
+void profiler_skip_frame(void);
+void profiler_reset_worst(void);
+
+// Phase intervals of the last complete frame, in order. Returns their
+// number, 0 when that frame was skipped or already taken.
+int profiler_take_slices(ProfSlice *out, int max, uint32_t *frame_start, uint32_t *frame_ticks);
+
+void profiler_set_hud(ProfHud hud);
+ProfHud profiler_get_hud(void);
+
+// Last frame as a bar in the title area, drawn on top after ui_end()
+void profiler_draw_hud(display_context_t disp);
+
+// Live tab pages: average/last budget per phase, worst-frame history
+void profiler_draw_budget(display_context_t disp, int y);
+void profiler_draw_worst(display_context_t disp, int y, const char* const *tag_names);
+
+#endif /* PROFILER_H */
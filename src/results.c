@@ -0,0 +1,292 @@
+#include <libdragon.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "results.h"
+#include "measurements.h"
+#include "ui.h"
+
+// EEPROM image: block 0 is the header, then two blocks per record
+//
+// Header:  "N64Z" | version | boot (BE16) | 0
+// Record:  bench | version | boot (BE16) | vi_frames (BE32) | score (float
+//          bits, BE32) | serial (BE16) | 0 | checksum
+#define RECORD_BYTES         16
+#define RECORD_BLOCKS        (RECORD_BYTES / EEPROM_BLOCK_SIZE)
+#define IMAGE_BLOCKS         (1 + RESULTS_MAX * RECORD_BLOCKS)
+
+// A block write keeps the EEPROM busy for up to 15 ms; writing every
+// other frame never catches it mid-write
+#define RESULTS_WRITE_FRAMES 2
+
+#define TREND_BAR_X          276
+#define TREND_BAR_W          34
+
+static const uint8_t header_magic[4] = { 'N', '6', '4', 'Z' };
+
+static uint8_t image[IMAGE_BLOCKS * EEPROM_BLOCK_SIZE];
+static uint32_t dirty[(IMAGE_BLOCKS + 31) / 32];
+static int pending = 0;
+static int wait_frames = 0;
+
+static int available = 0;
+static int slots = 0;
+static int eeprom_kbit = 0;
+static int next_slot = 0;
+static uint16_t next_serial = 0;
+static uint16_t boot = 0;
+
+static void put16(uint8_t *p, uint16_t v) {
+    p[0] = v >> 8;
+    p[1] = v;
+}
+
+static void put32(uint8_t *p, uint32_t v) {
+    p[0] = v >> 24;
+    p[1] = v >> 16;
+    p[2] = v >> 8;
+    p[3] = v;
+}
+
+static uint16_t get16(const uint8_t *p) {
+    return (p[0] << 8) | p[1];
+}
+
+static uint32_t get32(const uint8_t *p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+// Blank EEPROM (all 0x00 or all 0xFF) never passes
+static uint8_t checksum(const uint8_t *p) {
+    uint8_t sum = 0;
+    for (int i = 0; i < RECORD_BYTES - 1; i++) {
+        sum += p[i];
+    }
+    return ~sum;
+}
+
+static uint8_t *record_bytes(int slot) {
+    return &image[(1 + slot * RECORD_BLOCKS) * EEPROM_BLOCK_SIZE];
+}
+
+static int record_unpack(int slot, ResultRecord *r) {
+    const uint8_t *p = record_bytes(slot);
+    if (p[1] != RESULTS_VERSION || p[RECORD_BYTES - 1] != checksum(p)) {
+        return 0;
+    }
+
+    uint32_t bits = get32(p + 8);
+    r->bench = p[0];
+    r->boot = get16(p + 2);
+    r->vi_frames = get32(p + 4);
+    memcpy(&r->score, &bits, sizeof(bits));
+    r->serial = get16(p + 12);
+    return 1;
+}
+
+static void record_pack(int slot, const ResultRecord *r) {
+    uint8_t *p = record_bytes(slot);
+    uint32_t bits;
+
+    memcpy(&bits, &r->score, sizeof(bits));
+    memset(p, 0, RECORD_BYTES);
+    p[0] = r->bench;
+    p[1] = RESULTS_VERSION;
+    put16(p + 2, r->boot);
+    put32(p + 4, r->vi_frames);
+    put32(p + 8, bits);
+    put16(p + 12, r->serial);
+    p[RECORD_BYTES - 1] = checksum(p);
+}
+
+static void mark_dirty(int block) {
+    if (!(dirty[block / 32] & (1u << (block % 32)))) {
+        dirty[block / 32] |= 1u << (block % 32);
+        pending++;
+    }
+}
+
+void results_init(void) {
+    eeprom_type_t type = eeprom_present();
+    if (type == EEPROM_NONE) {
+        return;
+    }
+
+    eeprom_kbit = (type == EEPROM_16K) ? 16 : 4;
+    slots = (int)(eeprom_total_blocks() - 1) / RECORD_BLOCKS;
+    if (slots > RESULTS_MAX) slots = RESULTS_MAX;
+    available = 1;
+
+    // A one-time read at boot, before the first frame
+    for (int b = 0; b < 1 + slots * RECORD_BLOCKS; b++) {
+        eeprom_read(b, &image[b * EEPROM_BLOCK_SIZE]);
+    }
+
+    // Another format (or a blank chip) starts over; its records fail the
+    // per-record version check and are overwritten as the ring moves on
+    if (memcmp(image, header_magic, 4) != 0 || image[4] != RESULTS_VERSION) {
+        memset(image, 0, EEPROM_BLOCK_SIZE);
+        memcpy(image, header_magic, 4);
+        image[4] = RESULTS_VERSION;
+    }
+    boot = get16(image + 5) + 1;
+    put16(image + 5, boot);
+    mark_dirty(0);
+
+    // Continue after the newest record (serials are not expected to wrap)
+    int newest = -1;
+    for (int s = 0; s < slots; s++) {
+        ResultRecord r;
+        if (record_unpack(s, &r) && (newest < 0 || r.serial >= next_serial)) {
+            newest = s;
+            next_serial = r.serial + 1;
+        }
+    }
+    next_slot = (newest + 1) % slots;
+}
+
+int results_available(void) {
+    return available;
+}
+
+uint16_t results_boot(void) {
+    return boot;
+}
+
+void results_add(int bench, float score, uint32_t vi_frames) {
+    if (!available) {
+        return;
+    }
+
+    ResultRecord r = {
+        .bench = (uint8_t)bench,
+        .boot = boot,
+        .vi_frames = vi_frames,
+        .serial = next_serial++,
+        .score = score,
+    };
+    record_pack(next_slot, &r);
+    for (int b = 0; b < RECORD_BLOCKS; b++) {
+        mark_dirty(1 + next_slot * RECORD_BLOCKS + b);
+    }
+    next_slot = (next_slot + 1) % slots;
+}
+
+void results_pump(void) {
+    if (!pending) {
+        return;
+    }
+    if (wait_frames > 0) {
+        wait_frames--;
+        return;
+    }
+
+    // Records before the header, so the boot count commits last
+    int block = 0;
+    for (int b = 1; b < IMAGE_BLOCKS; b++) {
+        if (dirty[b / 32] & (1u << (b % 32))) {
+            block = b;
+            break;
+        }
+    }
+
+    eeprom_write(block, &image[block * EEPROM_BLOCK_SIZE]);
+    dirty[block / 32] &= ~(1u << (block % 32));
+    pending--;
+    wait_frames = RESULTS_WRITE_FRAMES - 1;
+}
+
+int results_pending(void) {
+    return pending;
+}
+
+int results_history(int bench, ResultRecord *out, int max) {
+    int n = 0;
+
+    // Insertion into a newest-first list of at most max entries
+    for (int s = 0; s < slots; s++) {
+        ResultRecord r;
+        if (!record_unpack(s, &r) || r.bench != bench) {
+            continue;
+        }
+        int i = (n < max) ? n++ : max;
+        while (i > 0 && out[i - 1].serial < r.serial) {
+            if (i < max) out[i] = out[i - 1];
+            i--;
+        }
+        if (i < max) out[i] = r;
+    }
+    return n;
+}
+
+static void format_time(char *buffer, size_t size, uint32_t vi_frames) {
+    uint32_t seconds = (uint32_t)(vi_frames / get_tv_refresh_rate());
+    if (seconds >= 3600) {
+        snprintf(buffer, size, "%lu:%02lu:%02lu", (unsigned long)(seconds / 3600),
+                 (unsigned long)(seconds / 60 % 60), (unsigned long)(seconds % 60));
+    } else {
+        snprintf(buffer, size, "%lu:%02lu", (unsigned long)(seconds / 60), (unsigned long)(seconds % 60));
+    }
+}
+
+void results_draw_trend(display_context_t disp, int y, int bench, const Benchmark *b) {
+    ResultRecord runs[RESULTS_TREND_ROWS];
+    char buffer[64];
+
+    snprintf(buffer, sizeof(buffer), "Saved: %s (%s)", b->score_name, b->score_unit);
+    ui_draw_text(disp, 15, y, buffer);
+    y += UI_LINE_HEIGHT + 2;
+
+    if (!available) {
+        ui_draw_text(disp, 20, y, "No EEPROM, results are not saved");
+        return;
+    }
+
+    int n = results_history(bench, runs, RESULTS_TREND_ROWS);
+    if (n == 0) {
+        ui_draw_text(disp, 20, y, "No saved runs yet");
+        return;
+    }
+
+    float best = 0.0f;
+    for (int i = 0; i < n; i++) {
+        if (runs[i].score > best) best = runs[i].score;
+    }
+
+    snprintf(buffer, sizeof(buffer), "%4s %7s %10s %7s", "Boot", "Time", "Score", "Change");
+    ui_draw_text(disp, 20, y, buffer);
+    y += UI_LINE_HEIGHT;
+
+    for (int i = 0; i < n; i++) {
+        const ResultRecord *r = &runs[i];
+        char time[16];
+        format_time(time, sizeof(time), r->vi_frames);
+
+        snprintf(buffer, sizeof(buffer), "%4u %7s %10.2f", r->boot, time, r->score);
+        ui_draw_text(disp, 20, y, buffer);
+
+        // Change against the run before it, colored by direction
+        if (i + 1 < n && runs[i + 1].score != 0.0f) {
+            float change = (r->score - runs[i + 1].score) * 100.0f / runs[i + 1].score;
+            int better = b->lower_is_better ? change < 0.0f : change > 0.0f;
+            UiColor color = (change > -1.0f && change < 1.0f) ? UI_COLOR_TEXT :
+                            better ? UI_COLOR_GREEN : UI_COLOR_RED;
+            snprintf(buffer, sizeof(buffer), "%+6.1f%%", change);
+            ui_set_color(color, UI_COLOR_BACKGROUND);
+            ui_draw_text(disp, 20 + 24 * 8, y, buffer);
+            ui_set_color(UI_COLOR_TEXT, UI_COLOR_BACKGROUND);
+        }
+
+        if (best > 0.0f) {
+            int w = (int)(r->score * TREND_BAR_W / best);
+            ui_draw_box(disp, TREND_BAR_X, y, w > 1 ? w : 1, 7, i == 0 ? UI_COLOR_CYAN : UI_COLOR_BLUE);
+        }
+        y += UI_LINE_HEIGHT;
+    }
+
+    y += 3;
+    snprintf(buffer, sizeof(buffer), "EEPROM %dK: %d slots, boot %u%s", eeprom_kbit, slots, boot,
+             pending ? ", saving" : "");
+    ui_draw_field(disp, 15, y, buffer);
+}
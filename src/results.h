@@ -0,0 +1,43 @@
+#ifndef RESULTS_H
+#define RESULTS_H
+
+#include <libdragon.h>
+#include <stdint.h>
+
+#include "bench.h"
+
+// Benchmark results kept in cartridge EEPROM across power cycles. Each run
+// is a 16-byte record in a ring (31 on a 4 Kbit EEPROM, 127 on 16 Kbit);
+// block 0 holds the format version and a boot counter. Writes are queued
+// and trickle out one 8-byte block at a time from results_pump().
+#define RESULTS_VERSION      1
+#define RESULTS_MAX          127
+#define RESULTS_TREND_ROWS   10     // Past runs listed on the trend page
+
+typedef struct {
+    uint8_t bench;          // Index into the benchmark table
+    uint16_t boot;          // Boot counter at the time of the run
+    uint32_t vi_frames;     // VI interrupts since that boot
+    uint16_t serial;        // Orders the ring, newest is highest
+    float score;
+} ResultRecord;
+
+// Detects the EEPROM, loads the store and counts this boot
+void results_init(void);
+int results_available(void);
+uint16_t results_boot(void);
+
+// Store a run; the EEPROM write happens over the next few frames
+void results_add(int bench, float score, uint32_t vi_frames);
+
+// Write at most one queued block, once every RESULTS_WRITE_FRAMES calls
+void results_pump(void);
+int results_pending(void);
+
+// Runs of one benchmark, newest first; returns their number
+int results_history(int bench, ResultRecord *out, int max);
+
+// Bench tab page: past scores of a benchmark with the change per run
+void results_draw_trend(display_context_t disp, int y, int bench, const Benchmark *b);
+
+#endif /* RESULTS_H */
@@ -0,0 +1,174 @@
+#include <libdragon.h>
+#include <stdio.h>
+
+#include "settings.h"
+#include "ui.h"
+#include "measurements.h"
+#include "profiler.h"
+#include "telemetry.h"
+
+typedef struct {
+    const char *label;
+    int count;                      // Number of values
+    const char* const *names;       // Display name of each value
+    int (*get)(void);
+    void (*set)(int value);
+} Setting;
+
+static int get_backend(void) { return ui_get_backend(); }
+static void set_backend(int value) { ui_set_backend((UiBackend)value); }
+static int get_redraw(void) { return ui_get_redraw(); }
+static void set_redraw(int value) { ui_set_redraw((UiRedraw)value); }
+static int get_background(void) { return ui_get_background_mode(); }
+static void set_background(int value) { ui_set_background_mode((UiBackgroundMode)value); }
+static int get_depth(void) { return ui_get_depth(); }
+static void set_depth(int value) { ui_set_depth((UiDepth)value); }
+static int get_acquire(void) { return ui_get_acquire(); }
+static void set_acquire(int value) { ui_set_acquire((UiAcquire)value); }
+static int get_render_rate(void) { return ui_get_render_rate(); }
+static void set_render_rate(int value) { ui_set_render_rate((UiRenderRate)value); }
+static int get_sample_rate(void) { return measurements_get_rate(); }
+static void set_sample_rate(int value) { measurements_set_rate((MeasureRate)value); }
+static int get_hud(void) { return profiler_get_hud(); }
+static void set_hud(int value) { profiler_set_hud((ProfHud)value); }
+static int get_telemetry(void) { return telemetry_get_mode(); }
+static void set_telemetry(int value) { telemetry_set_mode((TelemetryMode)value); }
+static int get_text(void) { return ui_get_text_engine(); }
+static void set_text(int value) { ui_set_text_engine((UiTextEngine)value); }
+
+static const Setting settings[] = {
+    { "Renderer", UI_BACKEND_COUNT, ui_backend_names, get_backend, set_backend },
+    { "Redraw",   UI_REDRAW_COUNT,  ui_redraw_names,  get_redraw,  set_redraw },
+    { "Backgrounds", UI_BACKGROUND_COUNT, ui_background_names, get_background, set_background },
+    { "Text",     UI_TEXT_COUNT,    ui_text_names,    get_text,    set_text },
+    { "Color Depth", UI_DEPTH_COUNT, ui_depth_names,  get_depth,   set_depth },
+    { "Frame Acquire", UI_ACQUIRE_COUNT, ui_acquire_names, get_acquire, set_acquire },
+    { "Render Rate", UI_RENDER_COUNT, ui_render_rate_names, get_render_rate, set_render_rate },
+    { "Sample Rate", MEASURE_RATE_COUNT, measure_rate_names, get_sample_rate, set_sample_rate },
+    { "Profiler HUD", PROF_HUD_COUNT, profiler_hud_names, get_hud, set_hud },
+    { "Telemetry", TELEMETRY_MODE_COUNT, telemetry_mode_names, get_telemetry, set_telemetry },
+};
+#define SETTING_COUNT (int)(sizeof(settings) / sizeof(settings[0]))
+
+static int selected = 0;
+
+void settings_input(const struct controller_data *keys) {
+    if (keys->c[0].up) {
+        selected = (selected - 1 + SETTING_COUNT) % SETTING_COUNT;
+        ui_invalidate();
+    }
+    if (keys->c[0].down) {
+        selected = (selected + 1) % SETTING_COUNT;
+        ui_invalidate();
+    }
+    if (keys->c[0].A) {
+        const Setting *s = &settings[selected];
+        s->set((s->get() + 1) % s->count);
+        ui_invalidate();
+    }
+}
+
+int settings_count(void) {
+    return SETTING_COUNT;
+}
+
+const char* settings_label(int setting) {
+    return settings[setting].label;
+}
+
+int settings_value_count(int setting) {
+    return settings[setting].count;
+}
+
+const char* settings_value_name(int setting, int value) {
+    return settings[setting].names[value];
+}
+
+int settings_get(int setting) {
+    return settings[setting].get();
+}
+
+void settings_set(int setting, int value) {
+    settings[setting].set(value);
+    ui_invalidate();
+}
+
+static void draw_settings(display_context_t disp, int y) {
+    int line_height = UI_LINE_HEIGHT;
+
+    ui_draw_text(disp, 15, y, "Settings");
+    y += line_height + 2;
+
+    for (int i = 0; i < SETTING_COUNT; i++) {
+        const Setting *s = &settings[i];
+        if (i == selected) {
+            ui_draw_box(disp, 16, y - 2, 288, line_height, UI_COLOR_HIGHLIGHT);
+            ui_set_color(UI_COLOR_TEXT, UI_COLOR_HIGHLIGHT);
+        }
+        draw_label_value(disp, 20, y, s->label, s->names[s->get()]);
+        ui_set_color(UI_COLOR_TEXT, UI_COLOR_BACKGROUND);
+        y += line_height;
+    }
+}
+
+static void draw_costs(display_context_t disp, int y) {
+    int line_height = UI_LINE_HEIGHT;
+    char buffer[64];
+
+    // CPU cost of issuing the UI, so the backends can be compared
+    ui_draw_text(disp, 15, y, "UI CPU Time / Frame");
+    y += line_height + 2;
+
+    float cpu = ui_cpu_time_us(UI_BACKEND_CPU);
+    float rdp = ui_cpu_time_us(UI_BACKEND_RDP);
+    snprintf(buffer, sizeof(buffer), "%.0f / %.0f us", cpu, rdp);
+    draw_label_value(disp, 20, y, "CPU / RDP", buffer);
+    y += line_height;
+
+    if (cpu > 0.0f && rdp > 0.0f) {
+        snprintf(buffer, sizeof(buffer), "%.0f us (%.0f%%)", cpu - rdp, (cpu - rdp) * 100.0f / cpu);
+    } else {
+        snprintf(buffer, sizeof(buffer), "try both renderers");
+    }
+    draw_label_value(disp, 20, y, "Saved by RDP", buffer);
+    y += line_height;
+
+    snprintf(buffer, sizeof(buffer), "%d", ui_fields_redrawn());
+    draw_label_value(disp, 20, y, "Fields Redrawn", buffer);
+    y += line_height;
+
+    // Time blocked on a framebuffer; spinning also polls RCP registers
+    snprintf(buffer, sizeof(buffer), "%.0f / %.0f us",
+             ui_wait_time_us(UI_ACQUIRE_SPIN), ui_wait_time_us(UI_ACQUIRE_WAIT));
+    draw_label_value(disp, 20, y, "Wait (Spin / Wait)", buffer);
+    y += line_height;
+
+    // The Wait mode idles on a cached flag in between
+    snprintf(buffer, sizeof(buffer), "%.0f / %.1f",
+             ui_rcp_polls(UI_ACQUIRE_SPIN), ui_rcp_polls(UI_ACQUIRE_WAIT));
+    draw_label_value(disp, 20, y, "Polls (Spin / Wait)", buffer);
+    y += line_height + 3;
+
+    ui_draw_text(disp, 15, y, "Telemetry");
+    y += line_height + 2;
+
+    draw_label_value(disp, 20, y, "Debug Channel",
+                     telemetry_available() ? "ISViewer / USB" : "Not Found");
+    y += line_height;
+
+    snprintf(buffer, sizeof(buffer), "%lu", (unsigned long)telemetry_records_sent());
+    draw_label_value(disp, 20, y, "Records Sent", buffer);
+    y += line_height;
+
+    snprintf(buffer, sizeof(buffer), "%lu", (unsigned long)telemetry_records_dropped());
+    draw_label_value(disp, 20, y, "Records Dropped", buffer);
+    y += line_height;
+}
+
+void settings_draw(display_context_t disp, int y, int page) {
+    if (page == 0) {
+        draw_settings(disp, y);
+    } else {
+        draw_costs(disp, y);
+    }
+}
@@ -0,0 +1,20 @@
+#ifndef SETTINGS_H
+#define SETTINGS_H
+
+#include <libdragon.h>
+
+// Setup tab: runtime switches for rendering and measurement modes.
+// D-Up/D-Down selects a setting, A cycles its value. Page 1 shows what the
+// UI and the telemetry stream cost; page 2 is the A/B comparison (compare.c).
+void settings_input(const struct controller_data *keys);
+void settings_draw(display_context_t disp, int y, int page);
+
+// The same settings by index, for A/B comparisons (compare.c)
+int settings_count(void);
+const char* settings_label(int setting);
+int settings_value_count(int setting);
+const char* settings_value_name(int setting, int value);
+int settings_get(int setting);
+void settings_set(int setting, int value);
+
+#endif /* SETTINGS_H */
@@ -0,0 +1,181 @@
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "stats.h"
+
+void stats_running_init(StatsRunning *s) {
+    memset(s, 0, sizeof(*s));
+}
+
+void stats_running_add(StatsRunning *s, double x) {
+    if (s->n == 0 || x < s->min) s->min = x;
+    if (s->n == 0 || x > s->max) s->max = x;
+
+    s->n++;
+    double d = x - s->mean;
+    s->mean += d / s->n;
+    s->m2 += d * (x - s->mean);
+}
+
+double stats_running_variance(const StatsRunning *s) {
+    return s->n > 1 ? s->m2 / (s->n - 1) : 0.0;
+}
+
+double stats_running_stddev(const StatsRunning *s) {
+    return sqrt(stats_running_variance(s));
+}
+
+// Two-sided 5% critical values of Student's t for 1 to 30 degrees of freedom
+static const double t95_table[30] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042,
+};
+
+double stats_t95(double df) {
+    if (df < 1.0) {
+        return t95_table[0];
+    }
+    if (df < 31.0) {
+        return t95_table[(int)df - 1];
+    }
+    // Beyond the table t approaches the normal 1.960 roughly as 1/df
+    return 1.960 + (t95_table[29] - 1.960) * 30.0 / df;
+}
+
+StatsWelch stats_welch(const StatsRunning *a, const StatsRunning *b) {
+    StatsWelch w;
+    memset(&w, 0, sizeof(w));
+    if (a->n < 2 || b->n < 2) {
+        return w;
+    }
+
+    double va = stats_running_variance(a) / a->n;
+    double vb = stats_running_variance(b) / b->n;
+    w.diff = b->mean - a->mean;
+    w.se = sqrt(va + vb);
+
+    // Noise-free scores: any difference is real
+    if (w.se == 0.0) {
+        w.df = a->n + b->n - 2;
+        w.significant = w.diff != 0.0;
+        return w;
+    }
+
+    w.df = (va + vb) * (va + vb) / (va * va / (a->n - 1) + vb * vb / (b->n - 1));
+    w.t = w.diff / w.se;
+    w.ci95 = stats_t95(w.df) * w.se;
+    w.significant = fabs(w.diff) > w.ci95;
+    return w;
+}
+
+void stats_quantile_init(StatsQuantile *s, double p) {
+    memset(s, 0, sizeof(*s));
+    s->p = p;
+    for (int i = 0; i < 5; i++) {
+        s->pos[i] = i + 1;
+    }
+    s->want[0] = 1;
+    s->want[1] = 1 + 2 * p;
+    s->want[2] = 1 + 4 * p;
+    s->want[3] = 3 + 2 * p;
+    s->want[4] = 5;
+    s->step[0] = 0;
+    s->step[1] = p / 2;
+    s->step[2] = p;
+    s->step[3] = (1 + p) / 2;
+    s->step[4] = 1;
+}
+
+// Piecewise-parabolic prediction of marker i moved by d (+1 or -1)
+static double parabolic(const StatsQuantile *s, int i, double d) {
+    const double *q = s->q, *n = s->pos;
+    return q[i] + d / (n[i + 1] - n[i - 1]) *
+           ((n[i] - n[i - 1] + d) * (q[i + 1] - q[i]) / (n[i + 1] - n[i]) +
+            (n[i + 1] - n[i] - d) * (q[i] - q[i - 1]) / (n[i] - n[i - 1]));
+}
+
+static double linear(const StatsQuantile *s, int i, int d) {
+    return s->q[i] + d * (s->q[i + d] - s->q[i]) / (s->pos[i + d] - s->pos[i]);
+}
+
+void stats_quantile_add(StatsQuantile *s, double x) {
+    int k;
+
+    // The first five values are kept sorted as the initial markers
+    if (s->n < 5) {
+        int i = (int)s->n++;
+        while (i > 0 && s->q[i - 1] > x) {
+            s->q[i] = s->q[i - 1];
+            i--;
+        }
+        s->q[i] = x;
+        return;
+    }
+    s->n++;
+
+    // Find the cell holding x, stretching the end markers if needed
+    if (x < s->q[0]) {
+        s->q[0] = x;
+        k = 0;
+    } else if (x >= s->q[4]) {
+        if (x > s->q[4]) s->q[4] = x;
+        k = 3;
+    } else {
+        for (k = 0; k < 3 && x >= s->q[k + 1]; k++) {
+        }
+    }
+
+    for (int i = k + 1; i < 5; i++) {
+        s->pos[i] += 1;
+    }
+    for (int i = 0; i < 5; i++) {
+        s->want[i] += s->step[i];
+    }
+
+    // Move the middle markers toward their desired positions
+    for (int i = 1; i < 4; i++) {
+        double d = s->want[i] - s->pos[i];
+        if ((d >= 1 && s->pos[i + 1] - s->pos[i] > 1) ||
+            (d <= -1 && s->pos[i - 1] - s->pos[i] < -1)) {
+            int dir = d > 0 ? 1 : -1;
+            double q = parabolic(s, i, dir);
+            if (s->q[i - 1] < q && q < s->q[i + 1]) {
+                s->q[i] = q;
+            } else {
+                s->q[i] = linear(s, i, dir);
+            }
+            s->pos[i] += dir;
+        }
+    }
+}
+
+double stats_quantile_get(const StatsQuantile *s) {
+    if (s->n == 0) {
+        return 0.0;
+    }
+    if (s->n <= 5) {
+        // Nearest rank over the sorted values
+        int rank = (int)ceil(s->p * s->n);
+        return s->q[rank > 0 ? rank - 1 : 0];
+    }
+    return s->q[2];
+}
+
+void stats_regression_init(StatsRegression *s) {
+    memset(s, 0, sizeof(*s));
+}
+
+void stats_regression_add(StatsRegression *s, double x, double y) {
+    s->n++;
+    double dx = x - s->mean_x;
+    s->mean_x += dx / s->n;
+    s->mean_y += (y - s->mean_y) / s->n;
+    s->m2_x += dx * (x - s->mean_x);
+    s->c_xy += dx * (y - s->mean_y);
+}
+
+double stats_regression_slope(const StatsRegression *s) {
+    return s->m2_x > 0.0 ? s->c_xy / s->m2_x : 0.0;
+}
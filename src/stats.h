@@ -0,0 +1,67 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdint.h>
+
+// Streaming statistics with constant memory, for long captures. No
+// libdragon dependency, so the ROM and the host tools share it.
+
+// Count, mean and variance (Welford), plus min/max
+typedef struct {
+    uint32_t n;
+    double mean;
+    double m2;              // Sum of squared differences from the mean
+    double min;
+    double max;
+} StatsRunning;
+
+void stats_running_init(StatsRunning *s);
+void stats_running_add(StatsRunning *s, double x);
+double stats_running_variance(const StatsRunning *s);      // Sample variance
+double stats_running_stddev(const StatsRunning *s);
+
+// Welch's t-test for the difference of two means with unequal variances
+typedef struct {
+    double diff;            // mean(b) - mean(a)
+    double se;              // Standard error of diff
+    double df;              // Welch-Satterthwaite degrees of freedom
+    double t;               // diff / se, 0 when se is 0
+    double ci95;            // Half-width of the 95% confidence interval of diff
+    int significant;        // The interval excludes zero
+} StatsWelch;
+
+// Needs two values on each side; otherwise nothing is significant
+StatsWelch stats_welch(const StatsRunning *a, const StatsRunning *b);
+
+// Two-sided 5% critical value of Student's t (fractional df round down)
+double stats_t95(double df);
+
+// P-square quantile estimate (Jain & Chlamtac, 1985): five markers, no
+// stored samples. Exact until the fifth value.
+typedef struct {
+    double p;
+    uint32_t n;
+    double q[5];            // Marker heights
+    double pos[5];          // Actual marker positions (1-based)
+    double want[5];         // Desired marker positions
+    double step[5];         // Desired position increments
+} StatsQuantile;
+
+void stats_quantile_init(StatsQuantile *s, double p);
+void stats_quantile_add(StatsQuantile *s, double x);
+double stats_quantile_get(const StatsQuantile *s);
+
+// Least-squares line y = a + b * x, updated one point at a time
+typedef struct {
+    uint32_t n;
+    double mean_x;
+    double mean_y;
+    double m2_x;            // Sum of squared x differences
+    double c_xy;            // Co-moment of x and y
+} StatsRegression;
+
+void stats_regression_init(StatsRegression *s);
+void stats_regression_add(StatsRegression *s, double x, double y);
+double stats_regression_slope(const StatsRegression *s);   // 0 with fewer than 2 distinct x
+
+#endif /* STATS_H */
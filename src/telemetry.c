@@ -0,0 +1,196 @@
+#include <libdragon.h>
+#include <stdio.h>
+#include <stdint.h>
+
+#include "telemetry.h"
+#include "telemetry_codec.h"
+#include "profiler.h"
+#include "timeline.h"
+
+// Prefix + base64 of the largest frame + newline + NUL
+#define LINE_LEN     (3 + ((TELEMETRY_TRACE_FRAME_MAX + 2) / 3) * 4 + 2)
+#define QUEUE_LINES  32     // Must be a power of two
+
+const char* telemetry_mode_names[TELEMETRY_MODE_COUNT] = {
+    "Off",
+    "Metrics",
+    "Trace"
+};
+
+typedef struct {
+    char text[LINE_LEN];
+    uint16_t len;
+} TelemetryLine;
+
+static TelemetryLine queue[QUEUE_LINES];
+static uint32_t queue_head = 0;     // Next line to write out
+static uint32_t queue_tail = 0;     // Next free slot
+
+static TelemetryEncoder encoder;
+static TelemetryTrace trace;
+static uint32_t trace_frame = 0;
+static uint32_t count_khz = TICKS_PER_SECOND / 1000;
+static TelemetryMode mode = TELEMETRY_OFF;
+static int available = 0;
+static int budget = 0;
+static uint32_t sent = 0;
+static uint32_t dropped = 0;
+
+void telemetry_init(void) {
+    available = debug_init(DEBUG_FEATURE_LOG_ISVIEWER | DEBUG_FEATURE_LOG_USB);
+    telemetry_encoder_init(&encoder);
+}
+
+void telemetry_set_mode(TelemetryMode m) {
+    mode = available ? m : TELEMETRY_OFF;
+
+    // A new run starts with a key frame and an empty queue
+    telemetry_encoder_init(&encoder);
+    trace_frame = 0;
+    queue_head = queue_tail = 0;
+    budget = 0;
+}
+
+TelemetryMode telemetry_get_mode(void) {
+    return mode;
+}
+
+int telemetry_available(void) {
+    return available;
+}
+
+// Queue one frame as a text line, or count it as dropped
+static void enqueue(const uint8_t *frame, size_t len) {
+    if (queue_tail - queue_head == QUEUE_LINES) {
+        dropped++;
+        return;
+    }
+
+    TelemetryLine *line = &queue[queue_tail & (QUEUE_LINES - 1)];
+    char *p = line->text;
+    for (const char *s = TELEMETRY_LINE_PREFIX; *s; s++) {
+        *p++ = *s;
+    }
+    p += telemetry_base64_encode(frame, len, p);
+    *p++ = '\n';
+    *p = '\0';
+    line->len = (uint16_t)(p - line->text);
+    queue_tail++;
+}
+
+static int32_t scaled(float value, float scale) {
+    return (int32_t)(value * scale + 0.5f);
+}
+
+#define RECORD_FIELD_EXPORT(field, index, scale) values[index] = scaled((float)m->field, scale);
+#define RECORD_FIELD_NOEXPORT(field, index, scale)
+
+void telemetry_record(const SystemMeasurements *m, float irq_load_percent) {
+    int32_t values[TELEMETRY_FIELD_COUNT];
+    uint8_t frame[TELEMETRY_FRAME_MAX];
+
+    if (mode == TELEMETRY_OFF) {
+        return;
+    }
+
+    // Registered metrics marked EXPORT (metrics.h), then the derived values
+#define RECORD_FIELD(id, type, field, name, unit, sample, period, format, stats, history, color, export, \
+                     index, scale, ...) RECORD_FIELD_##export(field, index, scale)
+    METRIC_TABLE(RECORD_FIELD)
+#undef RECORD_FIELD
+    values[TELEMETRY_VI_FRAMES] = (int32_t)m->frames_counted;
+    values[TELEMETRY_VI_PER_SEC] = (int32_t)m->vi_interrupts_per_sec;
+    values[TELEMETRY_IRQ_LOAD_X100] = scaled(irq_load_percent, 100.0f);
+
+    // The trace converts COUNT ticks with the measured clock
+    if (m->cpu_freq_current > 0.0f) {
+        count_khz = (uint32_t)(m->cpu_freq_current * 500.0f + 0.5f);
+    }
+
+    // Always encode, so a dropped record shows up as a sequence gap and the
+    // host resynchronizes on the next key frame
+    enqueue(frame, telemetry_encode(&encoder, values, frame));
+}
+
+void telemetry_trace(void) {
+    static ProfSlice prof[PROF_SLICES];
+    static TimelineSlice lanes[TELEMETRY_TRACE_MAX];
+    static uint8_t frame[TELEMETRY_TRACE_FRAME_MAX];
+    uint32_t start, ticks;
+
+    if (mode != TELEMETRY_TRACING) {
+        return;
+    }
+
+    int prof_count = profiler_take_slices(prof, PROF_SLICES, &start, &ticks);
+    int lane_count = timeline_take_slices(lanes, TELEMETRY_TRACE_MAX);
+    if (prof_count == 0) {
+        return;
+    }
+
+    trace.frame = trace_frame++;
+    trace.count_khz = count_khz;
+    trace.start = start;
+    trace.ticks = ticks;
+    trace.count = 0;
+
+    // Profiler phases map onto the CPU slice names one to one
+    for (int i = 0; i < prof_count && trace.count < TELEMETRY_TRACE_MAX; i++) {
+        TelemetrySlice *s = &trace.slices[trace.count++];
+        s->name = TELEMETRY_SLICE_OTHER + prof[i].phase;
+        s->start = prof[i].start - start;
+        s->ticks = prof[i].ticks;
+    }
+
+    // The timeline frame starts a few ticks earlier; clip to this one
+    for (int i = 0; i < lane_count && trace.count < TELEMETRY_TRACE_MAX; i++) {
+        int32_t offset = (int32_t)(lanes[i].start - start);
+        uint32_t length = lanes[i].ticks;
+        if (offset < 0) {
+            if ((uint32_t)-offset >= length) {
+                continue;
+            }
+            length -= (uint32_t)-offset;
+            offset = 0;
+        }
+
+        TelemetrySlice *s = &trace.slices[trace.count++];
+        s->name = lanes[i].phase == TL_PHASE_RSP_TASK ? TELEMETRY_SLICE_RSP_TASK : TELEMETRY_SLICE_RDP_BATCH;
+        s->start = (uint32_t)offset;
+        s->ticks = length;
+    }
+
+    enqueue(frame, telemetry_encode_trace(&trace, frame));
+}
+
+void telemetry_pump(void) {
+    if (mode == TELEMETRY_OFF) {
+        return;
+    }
+
+    // Token bucket: unused budget carries over for one more frame at most
+    int per_frame = mode == TELEMETRY_TRACING ? TELEMETRY_TRACE_BYTES_PER_FRAME : TELEMETRY_BYTES_PER_FRAME;
+    budget += per_frame;
+    if (budget > 2 * per_frame) {
+        budget = 2 * per_frame;
+    }
+
+    while (queue_head != queue_tail) {
+        TelemetryLine *line = &queue[queue_head & (QUEUE_LINES - 1)];
+        if (line->len > budget) {
+            break;
+        }
+        fwrite(line->text, 1, line->len, stderr);
+        budget -= line->len;
+        queue_head++;
+        sent++;
+    }
+}
+
+uint32_t telemetry_records_sent(void) {
+    return sent;
+}
+
+uint32_t telemetry_records_dropped(void) {
+    return dropped;
+}
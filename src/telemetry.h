@@ -0,0 +1,42 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdint.h>
+
+#include "measurements.h"
+
+// Streams measurement snapshots over libdragon's debug channel (ISViewer
+// or USB) as text lines: TELEMETRY_LINE_PREFIX + base64 of one frame.
+typedef enum {
+    TELEMETRY_OFF = 0,
+    TELEMETRY_METRICS,      // Measurement records
+    TELEMETRY_TRACING,      // Records plus per-frame CPU/RSP/RDP trace frames
+    TELEMETRY_MODE_COUNT
+} TelemetryMode;
+
+extern const char* telemetry_mode_names[TELEMETRY_MODE_COUNT];
+
+#define TELEMETRY_BYTES_PER_FRAME 256   // Output budget per rendered frame
+#define TELEMETRY_TRACE_BYTES_PER_FRAME 768     // Budget with tracing on
+
+// Opens the debug channel; telemetry stays off when none is present
+void telemetry_init(void);
+
+void telemetry_set_mode(TelemetryMode mode);
+TelemetryMode telemetry_get_mode(void);
+int telemetry_available(void);
+
+// Encode one snapshot into the output queue (dropped when the queue is full)
+void telemetry_record(const SystemMeasurements *m, float irq_load_percent);
+
+// Encode the last complete frame's profiler phases and RSP/RDP activity
+// (tracing mode only). Call after profiler_frame() and timeline_frame_mark().
+void telemetry_trace(void);
+
+// Write queued lines, within the mode's per-frame byte budget
+void telemetry_pump(void);
+
+uint32_t telemetry_records_sent(void);
+uint32_t telemetry_records_dropped(void);
+
+#endif /* TELEMETRY_H */
@@ -0,0 +1,316 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "telemetry_codec.h"
+
+const char* telemetry_field_names[TELEMETRY_FIELD_COUNT] = {
+    "vi_frames",
+    "cpu_khz",
+    "bandwidth_mbps",
+    "fps_x100",
+    "scanline",
+    "vi_per_sec",
+    "irq_load_x100"
+};
+
+const char* telemetry_track_names[TELEMETRY_TRACK_COUNT] = {
+    "CPU",
+    "RSP",
+    "RDP"
+};
+
+const char* telemetry_slice_names[TELEMETRY_SLICE_COUNT] = {
+    "Other",
+    "Input",
+    "Wait",
+    "Snapshot",
+    "Clear",
+    "Chrome",
+    "Tab",
+    "Flush",
+    "Show",
+    "RSP task",
+    "RDP batch"
+};
+
+const uint8_t telemetry_slice_tracks[TELEMETRY_SLICE_COUNT] = {
+    TELEMETRY_TRACK_CPU,
+    TELEMETRY_TRACK_CPU,
+    TELEMETRY_TRACK_CPU,
+    TELEMETRY_TRACK_CPU,
+    TELEMETRY_TRACK_CPU,
+    TELEMETRY_TRACK_CPU,
+    TELEMETRY_TRACK_CPU,
+    TELEMETRY_TRACK_CPU,
+    TELEMETRY_TRACK_CPU,
+    TELEMETRY_TRACK_RSP,
+    TELEMETRY_TRACK_RDP
+};
+
+static const char base64_chars[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+uint32_t telemetry_zigzag(int32_t v) {
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+int32_t telemetry_unzigzag(uint32_t v) {
+    return (int32_t)((v >> 1) ^ (0u - (v & 1)));
+}
+
+size_t telemetry_put_varint(uint8_t *dst, uint32_t v) {
+    size_t n = 0;
+    while (v >= 0x80) {
+        dst[n++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    dst[n++] = (uint8_t)v;
+    return n;
+}
+
+size_t telemetry_get_varint(const uint8_t *src, size_t len, uint32_t *v) {
+    uint32_t result = 0;
+    for (size_t n = 0; n < len && n < 5; n++) {
+        result |= (uint32_t)(src[n] & 0x7F) << (7 * n);
+        if (!(src[n] & 0x80)) {
+            *v = result;
+            return n + 1;
+        }
+    }
+    return 0;
+}
+
+uint16_t telemetry_crc16(const uint8_t *data, size_t len) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (int b = 0; b < 8; b++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+void telemetry_encoder_init(TelemetryEncoder *enc) {
+    memset(enc, 0, sizeof(*enc));
+}
+
+void telemetry_decoder_init(TelemetryDecoder *dec) {
+    memset(dec, 0, sizeof(*dec));
+}
+
+// Length, magic and CRC, common to all frame types
+static TelemetryStatus check_frame(const uint8_t *src, size_t len) {
+    if (len < 5) {
+        return TELEMETRY_ERR_SHORT;
+    }
+    if (src[0] != TELEMETRY_MAGIC) {
+        return TELEMETRY_ERR_MAGIC;
+    }
+    if (telemetry_crc16(src + 1, len - 3) != (uint16_t)((src[len - 2] << 8) | src[len - 1])) {
+        return TELEMETRY_ERR_CRC;
+    }
+    return TELEMETRY_OK;
+}
+
+static size_t finish_frame(uint8_t *dst, size_t n) {
+    uint16_t crc = telemetry_crc16(dst + 1, n - 1);
+    dst[n++] = (uint8_t)(crc >> 8);
+    dst[n++] = (uint8_t)crc;
+    return n;
+}
+
+size_t telemetry_encode(TelemetryEncoder *enc, const int32_t values[TELEMETRY_FIELD_COUNT], uint8_t *dst) {
+    int key = (enc->seq % TELEMETRY_KEY_EVERY) == 0;
+    size_t n = 0;
+
+    dst[n++] = TELEMETRY_MAGIC;
+    dst[n++] = key ? TELEMETRY_KEY : TELEMETRY_DELTA;
+    n += telemetry_put_varint(dst + n, enc->seq);
+
+    // Deltas are taken modulo 2^32, so counters may wrap
+    for (int f = 0; f < TELEMETRY_FIELD_COUNT; f++) {
+        int32_t v = key ? values[f] : (int32_t)((uint32_t)values[f] - (uint32_t)enc->prev[f]);
+        n += telemetry_put_varint(dst + n, telemetry_zigzag(v));
+        enc->prev[f] = values[f];
+    }
+
+    enc->seq++;
+    return finish_frame(dst, n);
+}
+
+TelemetryStatus telemetry_decode(TelemetryDecoder *dec, const uint8_t *src, size_t len,
+                                 int32_t values[TELEMETRY_FIELD_COUNT], uint32_t *seq) {
+    int32_t fields[TELEMETRY_FIELD_COUNT];
+    uint32_t record_seq, v;
+    size_t n = 2, used;
+    TelemetryStatus status = check_frame(src, len);
+
+    if (status != TELEMETRY_OK) {
+        return status;
+    }
+    if (src[1] != TELEMETRY_KEY && src[1] != TELEMETRY_DELTA) {
+        return TELEMETRY_ERR_TYPE;
+    }
+
+    len -= 2;
+    if (!(used = telemetry_get_varint(src + n, len - n, &record_seq))) {
+        return TELEMETRY_ERR_SHORT;
+    }
+    n += used;
+
+    for (int f = 0; f < TELEMETRY_FIELD_COUNT; f++) {
+        if (!(used = telemetry_get_varint(src + n, len - n, &v))) {
+            return TELEMETRY_ERR_SHORT;
+        }
+        fields[f] = telemetry_unzigzag(v);
+        n += used;
+    }
+
+    if (src[1] == TELEMETRY_KEY) {
+        memcpy(dec->prev, fields, sizeof(fields));
+    } else {
+        // A delta only applies on top of the record right before it
+        if (!dec->synced || record_seq != dec->seq + 1) {
+            dec->synced = 0;
+            return TELEMETRY_ERR_UNSYNCED;
+        }
+        for (int f = 0; f < TELEMETRY_FIELD_COUNT; f++) {
+            dec->prev[f] = (int32_t)((uint32_t)dec->prev[f] + (uint32_t)fields[f]);
+        }
+    }
+
+    dec->synced = 1;
+    dec->seq = record_seq;
+    memcpy(values, dec->prev, sizeof(dec->prev));
+    *seq = record_seq;
+    return TELEMETRY_OK;
+}
+
+int telemetry_frame_type(const uint8_t *src, size_t len) {
+    return len >= 2 ? src[1] : 0;
+}
+
+size_t telemetry_encode_trace(const TelemetryTrace *trace, uint8_t *dst) {
+    int count = trace->count < TELEMETRY_TRACE_MAX ? trace->count : TELEMETRY_TRACE_MAX;
+    size_t n = 0;
+
+    dst[n++] = TELEMETRY_MAGIC;
+    dst[n++] = TELEMETRY_TRACE;
+    n += telemetry_put_varint(dst + n, trace->frame);
+    n += telemetry_put_varint(dst + n, trace->count_khz);
+    n += telemetry_put_varint(dst + n, trace->start);
+    n += telemetry_put_varint(dst + n, trace->ticks);
+    n += telemetry_put_varint(dst + n, (uint32_t)count);
+
+    for (int i = 0; i < count; i++) {
+        const TelemetrySlice *s = &trace->slices[i];
+        dst[n++] = s->name;
+        n += telemetry_put_varint(dst + n, s->start);
+        n += telemetry_put_varint(dst + n, s->ticks);
+    }
+
+    return finish_frame(dst, n);
+}
+
+TelemetryStatus telemetry_decode_trace(const uint8_t *src, size_t len, TelemetryTrace *trace) {
+    uint32_t header[5];
+    size_t n = 2, used;
+    TelemetryStatus status = check_frame(src, len);
+
+    if (status != TELEMETRY_OK) {
+        return status;
+    }
+    if (src[1] != TELEMETRY_TRACE) {
+        return TELEMETRY_ERR_TYPE;
+    }
+
+    len -= 2;
+    for (int i = 0; i < 5; i++) {
+        if (!(used = telemetry_get_varint(src + n, len - n, &header[i]))) {
+            return TELEMETRY_ERR_SHORT;
+        }
+        n += used;
+    }
+    if (header[4] > TELEMETRY_TRACE_MAX) {
+        return TELEMETRY_ERR_SHORT;
+    }
+    trace->frame = header[0];
+    trace->count_khz = header[1];
+    trace->start = header[2];
+    trace->ticks = header[3];
+    trace->count = (int)header[4];
+
+    for (int i = 0; i < trace->count; i++) {
+        TelemetrySlice *s = &trace->slices[i];
+        if (n >= len || src[n] >= TELEMETRY_SLICE_COUNT) {
+            return TELEMETRY_ERR_SHORT;
+        }
+        s->name = src[n++];
+        if (!(used = telemetry_get_varint(src + n, len - n, &s->start))) {
+            return TELEMETRY_ERR_SHORT;
+        }
+        n += used;
+        if (!(used = telemetry_get_varint(src + n, len - n, &s->ticks))) {
+            return TELEMETRY_ERR_SHORT;
+        }
+        n += used;
+    }
+    return TELEMETRY_OK;
+}
+
+size_t telemetry_base64_encode(const uint8_t *src, size_t len, char *dst) {
+    size_t n = 0;
+
+    for (size_t i = 0; i < len; i += 3) {
+        uint32_t chunk = (uint32_t)src[i] << 16;
+        if (i + 1 < len) chunk |= (uint32_t)src[i + 1] << 8;
+        if (i + 2 < len) chunk |= src[i + 2];
+
+        dst[n++] = base64_chars[(chunk >> 18) & 0x3F];
+        dst[n++] = base64_chars[(chunk >> 12) & 0x3F];
+        dst[n++] = (i + 1 < len) ? base64_chars[(chunk >> 6) & 0x3F] : '=';
+        dst[n++] = (i + 2 < len) ? base64_chars[chunk & 0x3F] : '=';
+    }
+    dst[n] = '\0';
+    return n;
+}
+
+static int base64_value(char c) {
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+    if (c >= '0' && c <= '9') return c - '0' + 52;
+    if (c == '+') return 62;
+    if (c == '/') return 63;
+    return -1;
+}
+
+long telemetry_base64_decode(const char *src, size_t len, uint8_t *dst) {
+    long n = 0;
+
+    if (len % 4 != 0) {
+        return -1;
+    }
+
+    for (size_t i = 0; i < len; i += 4) {
+        int pad = (src[i + 3] == '=') + (src[i + 2] == '=');
+        if (pad && i + 4 != len) {
+            return -1;
+        }
+
+        uint32_t chunk = 0;
+        for (int k = 0; k < 4; k++) {
+            int v = (k >= 4 - pad) ? 0 : base64_value(src[i + k]);
+            if (v < 0) {
+                return -1;
+            }
+            chunk = (chunk << 6) | (uint32_t)v;
+        }
+
+        dst[n++] = (uint8_t)(chunk >> 16);
+        if (pad < 2) dst[n++] = (uint8_t)(chunk >> 8);
+        if (pad < 1) dst[n++] = (uint8_t)chunk;
+    }
+    return n;
+}
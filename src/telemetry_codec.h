@@ -0,0 +1,134 @@
+#ifndef TELEMETRY_CODEC_H
+#define TELEMETRY_CODEC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Binary telemetry records, shared by the ROM (encoder) and host tools
+// (decoder). No libdragon dependency.
+//
+// Frame:  0xA5 | type | seq (varint) | fields (zigzag varints) | CRC-16 (BE)
+// A key frame carries absolute values, a delta frame the difference to the
+// previous record. The CRC (CCITT, init 0xFFFF) covers type through fields.
+// Trace frames use the same framing with their own payload (see below).
+#define TELEMETRY_MAGIC      0xA5
+#define TELEMETRY_KEY        1
+#define TELEMETRY_DELTA      2
+#define TELEMETRY_TRACE      3
+#define TELEMETRY_KEY_EVERY  32     // Records between key frames
+#define TELEMETRY_FRAME_MAX  (2 + 5 + TELEMETRY_FIELD_COUNT * 5 + 2)
+#define TELEMETRY_LINE_PREFIX "@T "  // Starts each base64 line on the debug channel
+
+// Quantized measurement snapshot, one integer per field
+typedef enum {
+    TELEMETRY_VI_FRAMES = 0,    // frames_counted
+    TELEMETRY_CPU_KHZ,          // cpu_freq_current * 1000
+    TELEMETRY_BANDWIDTH,        // MB/s
+    TELEMETRY_FPS_X100,         // actual_fps * 100
+    TELEMETRY_SCANLINE,
+    TELEMETRY_VI_PER_SEC,
+    TELEMETRY_IRQ_LOAD_X100,    // Interrupt handler CPU load, percent * 100
+    TELEMETRY_FIELD_COUNT
+} TelemetryField;
+
+extern const char* telemetry_field_names[TELEMETRY_FIELD_COUNT];
+
+typedef struct {
+    int32_t prev[TELEMETRY_FIELD_COUNT];
+    uint32_t seq;
+} TelemetryEncoder;
+
+typedef struct {
+    int32_t prev[TELEMETRY_FIELD_COUNT];
+    uint32_t seq;           // Sequence number of the last decoded record
+    int synced;             // A key frame has been seen since the last gap
+} TelemetryDecoder;
+
+typedef enum {
+    TELEMETRY_OK = 0,
+    TELEMETRY_ERR_SHORT = -1,       // Truncated frame or varint
+    TELEMETRY_ERR_MAGIC = -2,
+    TELEMETRY_ERR_CRC = -3,
+    TELEMETRY_ERR_TYPE = -4,
+    TELEMETRY_ERR_UNSYNCED = -5,    // Delta frame after a gap, wait for a key
+} TelemetryStatus;
+
+uint32_t telemetry_zigzag(int32_t v);
+int32_t telemetry_unzigzag(uint32_t v);
+
+// Varints: 7 bits per byte, least significant group first
+size_t telemetry_put_varint(uint8_t *dst, uint32_t v);
+size_t telemetry_get_varint(const uint8_t *src, size_t len, uint32_t *v);   // 0 on error
+
+uint16_t telemetry_crc16(const uint8_t *data, size_t len);
+
+void telemetry_encoder_init(TelemetryEncoder *enc);
+void telemetry_decoder_init(TelemetryDecoder *dec);
+
+// Encode one record into dst (at least TELEMETRY_FRAME_MAX bytes); returns its length
+size_t telemetry_encode(TelemetryEncoder *enc, const int32_t values[TELEMETRY_FIELD_COUNT], uint8_t *dst);
+
+// Decode one frame; on success values and seq hold the record
+TelemetryStatus telemetry_decode(TelemetryDecoder *dec, const uint8_t *src, size_t len,
+                                 int32_t values[TELEMETRY_FIELD_COUNT], uint32_t *seq);
+
+// Trace frame payload: frame number | COUNT rate in kHz | frame start
+// (COUNT) | frame length (ticks) | slice count | per slice: name (byte),
+// start (ticks from frame start), length (ticks). All varints.
+#define TELEMETRY_TRACE_MAX        24   // Slices per trace frame
+#define TELEMETRY_TRACE_FRAME_MAX  (2 + 5 * 5 + TELEMETRY_TRACE_MAX * 11 + 2)
+
+typedef enum {
+    TELEMETRY_TRACK_CPU = 0,
+    TELEMETRY_TRACK_RSP,
+    TELEMETRY_TRACK_RDP,
+    TELEMETRY_TRACK_COUNT
+} TelemetryTrack;
+
+// CPU slices follow the order of the ROM's profiler phases
+typedef enum {
+    TELEMETRY_SLICE_OTHER = 0,
+    TELEMETRY_SLICE_INPUT,
+    TELEMETRY_SLICE_WAIT,
+    TELEMETRY_SLICE_SNAPSHOT,
+    TELEMETRY_SLICE_CLEAR,
+    TELEMETRY_SLICE_CHROME,
+    TELEMETRY_SLICE_TAB,
+    TELEMETRY_SLICE_FLUSH,
+    TELEMETRY_SLICE_SHOW,
+    TELEMETRY_SLICE_RSP_TASK,
+    TELEMETRY_SLICE_RDP_BATCH,
+    TELEMETRY_SLICE_COUNT
+} TelemetrySliceName;
+
+extern const char* telemetry_track_names[TELEMETRY_TRACK_COUNT];
+extern const char* telemetry_slice_names[TELEMETRY_SLICE_COUNT];
+extern const uint8_t telemetry_slice_tracks[TELEMETRY_SLICE_COUNT];
+
+typedef struct {
+    uint8_t name;           // TelemetrySliceName
+    uint32_t start;         // Ticks from the frame start
+    uint32_t ticks;
+} TelemetrySlice;
+
+typedef struct {
+    uint32_t frame;
+    uint32_t count_khz;     // Measured COUNT rate (half the CPU clock)
+    uint32_t start;         // COUNT at the frame start, wraps
+    uint32_t ticks;
+    int count;
+    TelemetrySlice slices[TELEMETRY_TRACE_MAX];
+} TelemetryTrace;
+
+// Frame type (TELEMETRY_KEY/DELTA/TRACE) of a raw frame, 0 when too short
+int telemetry_frame_type(const uint8_t *src, size_t len);
+
+// dst holds at least TELEMETRY_TRACE_FRAME_MAX bytes; returns the length
+size_t telemetry_encode_trace(const TelemetryTrace *trace, uint8_t *dst);
+TelemetryStatus telemetry_decode_trace(const uint8_t *src, size_t len, TelemetryTrace *trace);
+
+// Base64 (RFC 4648, padded) so frames can travel as text lines
+size_t telemetry_base64_encode(const uint8_t *src, size_t len, char *dst);     // Writes a NUL
+long telemetry_base64_decode(const char *src, size_t len, uint8_t *dst);       // -1 on error
+
+#endif /* TELEMETRY_CODEC_H */
@@ -0,0 +1,243 @@
+#include <libdragon.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "text.h"
+#include "font8x8.h"
+
+// Direct atlas: RGBA16, 16 x 8 cells covering ASCII 0-127 (16 KB)
+#define ATLAS_COLUMNS   16
+#define ATLAS_ROWS      8
+
+// Batched atlas: I4, printable ASCII only, 128 x 48 texels = 3 KB of TMEM
+#define TMEM_FIRST_CHAR ' '
+#define TMEM_ROWS       6
+
+// Two screens of 40 x 22 glyphs
+#define TEXT_MAX_GLYPHS 2048
+
+typedef struct {
+    int16_t x, y;
+    uint8_t c;
+    uint8_t color;
+} QueuedGlyph;
+
+// One palette entry in every form the three paths consume, so selecting a
+// color is an index store rather than a conversion
+typedef struct {
+    uint32_t rgba;
+    color_t rdp;
+    uint64_t wide32;    // Pixel repeated for a 64-bit store: 2 x RGBA32
+    uint64_t wide16;    // 4 x RGBA16
+} TextColor;
+
+static surface_t glyph_atlas;
+static surface_t tmem_atlas;
+
+static QueuedGlyph queue[TEXT_MAX_GLYPHS];
+static int queue_len = 0;
+
+static TextColor palette[TEXT_PALETTE_MAX];
+static int text_fg = 0;
+static int text_bg = 0;
+
+// Packed renderer: font rows expanded through these masks into 64-bit stores
+// of 2 (RGBA32) or 4 (RGBA16) pixels, picking fg where the mask is set and
+// bg elsewhere. Index bit 0 is the left pixel.
+static uint64_t mask32[4];
+static uint64_t mask16[16];
+
+static int is_drawable(unsigned char c) {
+    return c > ' ' && c < 128;
+}
+
+void text_init(void) {
+    // Render the libdragon font once into a texture the RDP can sample
+    glyph_atlas = surface_alloc(FMT_RGBA16, ATLAS_COLUMNS * TEXT_GLYPH_SIZE, ATLAS_ROWS * TEXT_GLYPH_SIZE);
+    memset(glyph_atlas.buffer, 0, glyph_atlas.stride * glyph_atlas.height);
+
+    graphics_set_color(0xFFFFFFFF, 0x00000000);
+    for (int c = ' '; c < 128; c++) {
+        graphics_draw_character(&glyph_atlas, (c % ATLAS_COLUMNS) * TEXT_GLYPH_SIZE,
+                                (c / ATLAS_COLUMNS) * TEXT_GLYPH_SIZE, c);
+    }
+    data_cache_hit_writeback(glyph_atlas.buffer, glyph_atlas.stride * glyph_atlas.height);
+
+    // Repack the printable rows as 4-bit intensity, two texels per byte
+    int first_row = TMEM_FIRST_CHAR / ATLAS_COLUMNS;
+    tmem_atlas = surface_alloc(FMT_I4, ATLAS_COLUMNS * TEXT_GLYPH_SIZE, TMEM_ROWS * TEXT_GLYPH_SIZE);
+    memset(tmem_atlas.buffer, 0, tmem_atlas.stride * tmem_atlas.height);
+
+    for (int y = 0; y < tmem_atlas.height; y++) {
+        const uint16_t *src = (const uint16_t *)((uint8_t *)glyph_atlas.buffer +
+                              (y + first_row * TEXT_GLYPH_SIZE) * glyph_atlas.stride);
+        uint8_t *dst = (uint8_t *)tmem_atlas.buffer + y * tmem_atlas.stride;
+        for (int x = 0; x < tmem_atlas.width; x++) {
+            if (src[x] & 1) {
+                dst[x / 2] |= (x & 1) ? 0x0F : 0xF0;
+            }
+        }
+    }
+    data_cache_hit_writeback(tmem_atlas.buffer, tmem_atlas.stride * tmem_atlas.height);
+
+    for (int i = 0; i < 4; i++) {
+        mask32[i] = ((i & 1) ? 0xFFFFFFFF00000000ull : 0) | ((i & 2) ? 0x00000000FFFFFFFFull : 0);
+    }
+    for (int i = 0; i < 16; i++) {
+        mask16[i] = 0;
+        for (int px = 0; px < 4; px++) {
+            mask16[i] |= ((i >> px) & 1 ? 0xFFFFull : 0) << (48 - px * 16);
+        }
+    }
+
+    static const uint32_t mono[] = { 0x00000000, 0xFFFFFFFF };
+    text_set_palette(mono, 2);
+    text_set_color(1, 0);
+}
+
+void text_set_palette(const uint32_t *rgba, int count) {
+    if (count > TEXT_PALETTE_MAX) {
+        count = TEXT_PALETTE_MAX;
+    }
+    for (int i = 0; i < count; i++) {
+        TextColor *entry = &palette[i];
+        uint64_t packed16 = color_to_packed16(color_from_packed32(rgba[i]));
+
+        entry->rgba = rgba[i];
+        entry->rdp = color_from_packed32(rgba[i]);
+        entry->wide32 = ((uint64_t)rgba[i] << 32) | rgba[i];
+        entry->wide16 = packed16 * 0x0001000100010001ull;
+    }
+}
+
+void text_set_color(int fg, int bg) {
+    text_fg = fg;
+    text_bg = bg;
+}
+
+void text_draw_direct(int x, int y, const char* text) {
+    // One textured rectangle per glyph, transparent where the atlas is empty
+    rdpq_set_mode_standard();
+    rdpq_mode_combiner(RDPQ_COMBINER_TEX_FLAT);
+    rdpq_mode_alphacompare(1);
+    rdpq_set_prim_color(palette[text_fg].rdp);
+
+    for (; *text; text++, x += TEXT_GLYPH_SIZE) {
+        unsigned char c = *text;
+        if (!is_drawable(c)) {
+            continue;
+        }
+        surface_t glyph = surface_make_sub(&glyph_atlas, (c % ATLAS_COLUMNS) * TEXT_GLYPH_SIZE,
+                                           (c / ATLAS_COLUMNS) * TEXT_GLYPH_SIZE,
+                                           TEXT_GLYPH_SIZE, TEXT_GLYPH_SIZE);
+        rdpq_tex_blit(&glyph, x, y, NULL);
+    }
+}
+
+void text_queue(int x, int y, const char* text) {
+    for (; *text; text++, x += TEXT_GLYPH_SIZE) {
+        unsigned char c = *text;
+        if (!is_drawable(c) || queue_len == TEXT_MAX_GLYPHS) {
+            continue;
+        }
+        queue[queue_len].x = x;
+        queue[queue_len].y = y;
+        queue[queue_len].c = c;
+        queue[queue_len].color = text_fg;
+        queue_len++;
+    }
+}
+
+int text_queued(void) {
+    return queue_len;
+}
+
+void text_flush(void) {
+    if (queue_len == 0) {
+        return;
+    }
+
+    // Primitive color for the glyph, atlas intensity as coverage
+    rdpq_set_mode_standard();
+    rdpq_mode_combiner(RDPQ_COMBINER1((0,0,0,PRIM), (0,0,0,TEX0)));
+    rdpq_mode_alphacompare(1);
+    rdpq_tex_upload(TILE0, &tmem_atlas, NULL);
+
+    int color = -1;
+    for (int i = 0; i < queue_len; i++) {
+        const QueuedGlyph *g = &queue[i];
+        int cell = g->c - TMEM_FIRST_CHAR;
+        if (g->color != color) {
+            color = g->color;
+            rdpq_set_prim_color(palette[color].rdp);
+        }
+        rdpq_texture_rectangle(TILE0, g->x, g->y,
+                               g->x + TEXT_GLYPH_SIZE, g->y + TEXT_GLYPH_SIZE,
+                               (cell % ATLAS_COLUMNS) * TEXT_GLYPH_SIZE,
+                               (cell / ATLAS_COLUMNS) * TEXT_GLYPH_SIZE);
+    }
+    queue_len = 0;
+}
+
+void text_draw_packed(surface_t *surf, int x, int y, const char* text) {
+    int bpp = TEX_FORMAT_PIX2BYTES(surface_get_format(surf), 1);
+    int len = strlen(text);
+
+    if (x < 0 || y < 0 || y + TEXT_GLYPH_SIZE > surf->height) {
+        return;
+    }
+    if (x + len * TEXT_GLYPH_SIZE > surf->width) {
+        len = (surf->width - x) / TEXT_GLYPH_SIZE;
+    }
+    if (len <= 0) {
+        return;
+    }
+
+    // Write through the cached alias: stores merge into cache lines and reach
+    // RDRAM as whole-line writebacks instead of one bus write per pixel
+    uint8_t *base = (uint8_t *)CachedAddr(surf->buffer) + y * surf->stride + x * bpp;
+    int aligned = ((uintptr_t)base & 7) == 0;
+
+    // fg where the mask is set: bg ^ (mask & (fg ^ bg))
+    const TextColor *fg = &palette[text_fg];
+    const TextColor *bg = &palette[text_bg];
+    uint64_t bg64 = bpp == 4 ? bg->wide32 : bg->wide16;
+    uint64_t diff = bg64 ^ (bpp == 4 ? fg->wide32 : fg->wide16);
+
+    for (int i = 0; i < len; i++) {
+        unsigned char c = text[i];
+        const uint8_t *glyph = font8x8[(c >= FONT8X8_FIRST && c < 128) ? c - FONT8X8_FIRST : 0];
+        uint8_t *cell = base + i * TEXT_GLYPH_SIZE * bpp;
+
+        for (int row = 0; row < TEXT_GLYPH_SIZE; row++, cell += surf->stride) {
+            uint8_t bits = glyph[row];
+
+            if (aligned && bpp == 4) {
+                uint64_t *dst = (uint64_t *)cell;
+                dst[0] = bg64 ^ (mask32[bits & 3] & diff);
+                dst[1] = bg64 ^ (mask32[(bits >> 2) & 3] & diff);
+                dst[2] = bg64 ^ (mask32[(bits >> 4) & 3] & diff);
+                dst[3] = bg64 ^ (mask32[bits >> 6] & diff);
+            } else if (aligned && bpp == 2) {
+                uint64_t *dst = (uint64_t *)cell;
+                dst[0] = bg64 ^ (mask16[bits & 15] & diff);
+                dst[1] = bg64 ^ (mask16[bits >> 4] & diff);
+            } else if (bpp == 4) {
+                uint32_t *dst = (uint32_t *)cell;
+                for (int px = 0; px < TEXT_GLYPH_SIZE; px++) {
+                    dst[px] = (bits >> px) & 1 ? fg->rgba : bg->rgba;
+                }
+            } else {
+                uint16_t *dst = (uint16_t *)cell;
+                for (int px = 0; px < TEXT_GLYPH_SIZE; px++) {
+                    dst[px] = (bits >> px) & 1 ? fg->wide16 : bg->wide16;
+                }
+            }
+        }
+    }
+
+    // Invalidate as well: the RDP and uncached writes may change these lines
+    for (int row = 0; row < TEXT_GLYPH_SIZE; row++) {
+        data_cache_hit_writeback_invalidate(base + row * surf->stride, len * TEXT_GLYPH_SIZE * bpp);
+    }
+}
@@ -0,0 +1,35 @@
+#ifndef TEXT_H
+#define TEXT_H
+
+#include <libdragon.h>
+
+// Text rendering paths for the UI. The RDP paths draw from a glyph atlas of
+// the built-in 8x8 font into the surface currently attached to rdpq.
+#define TEXT_GLYPH_SIZE 8
+
+// Build both atlases (call once after display_init and rdpq_init)
+void text_init(void);
+
+// Palette of RGBA8888 colors, converted for every path once per call (at
+// most TEXT_PALETTE_MAX entries). text_init installs black and white.
+#define TEXT_PALETTE_MAX 16
+void text_set_palette(const uint32_t *rgba, int count);
+
+// Select palette indices. Only the packed renderer draws the background;
+// the RDP paths leave it transparent.
+void text_set_color(int fg, int bg);
+
+// Direct path: one rdpq_tex_blit per glyph, each reloading TMEM
+void text_draw_direct(int x, int y, const char* text);
+
+// Batched path: glyphs are queued, then emitted with a single TMEM load of
+// the whole atlas followed by one textured rectangle per glyph
+void text_queue(int x, int y, const char* text);
+int text_queued(void);
+void text_flush(void);
+
+// Packed CPU path: a 1bpp font expanded with 64-bit stores straight into an
+// RGBA16 or RGBA32 surface, opaque cells, no RDP involvement
+void text_draw_packed(surface_t *surf, int x, int y, const char* text);
+
+#endif /* TEXT_H */
@@ -0,0 +1,275 @@
+#include <libdragon.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "timeline.h"
+#include "fmt.h"
+#include "hw.h"
+#include "ui.h"
+
+// Gantt bar geometry
+#define TL_BAR_X      50
+#define TL_BAR_WIDTH  256
+#define TL_LANE_H     10
+#define TL_LANE_GAP   4
+
+static const uint8_t phase_lane[TL_PHASE_COUNT] = {
+    TL_LANE_CPU,
+    TL_LANE_CPU,
+    TL_LANE_CPU,
+    TL_LANE_RSP,
+    TL_LANE_RDP
+};
+
+static const char* phase_names[TL_PHASE_COUNT] = {
+    "Update",
+    "Draw",
+    "Show",
+    "RSP",
+    "RDP"
+};
+
+static const UiColor phase_colors[TL_PHASE_COUNT] = {
+    UI_COLOR_BLUE,
+    UI_COLOR_GREEN,
+    UI_COLOR_YELLOW,
+    UI_COLOR_RED,
+    UI_COLOR_PURPLE
+};
+
+static const char* lane_names[TL_LANE_COUNT] = {
+    "CPU",
+    "RSP",
+    "RDP"
+};
+
+// Start of a frame: ring position, timestamp and which phase each lane was in
+typedef struct {
+    uint32_t index;
+    uint32_t count;
+    uint8_t lane_state[TL_LANE_COUNT];  // Open phase + 1, or 0 when idle
+} TimelineMark;
+
+static TimelineEvent ring[TL_RING_SIZE];
+static volatile uint32_t ring_head = 0;
+static uint8_t lane_state[TL_LANE_COUNT];
+
+static TimelineMark frame_prev;
+static TimelineMark frame_cur;
+static int frames_marked = 0;
+static int frames_taken = 0;
+
+// May be called from interrupt context
+static void timeline_push(TimelinePhase phase, int begin) {
+    disable_interrupts();
+    TimelineEvent *ev = &ring[ring_head & (TL_RING_SIZE - 1)];
+    ev->count = read_c0_count();
+    ev->lane = phase_lane[phase];
+    ev->phase = phase;
+    ev->begin = begin;
+    lane_state[ev->lane] = begin ? phase + 1 : 0;
+    ring_head++;
+    enable_interrupts();
+}
+
+static void timeline_set_busy(TimelinePhase phase, int busy) {
+    int open = lane_state[phase_lane[phase]] != 0;
+    if (busy != open) {
+        timeline_push(phase, busy);
+    }
+}
+
+// Log RSP/RDP edges by sampling their status registers
+static void timeline_poll(void) {
+    volatile uint32_t *sp_status = (uint32_t *)SP_STATUS_REG;
+    volatile uint32_t *dpc_status = (uint32_t *)DPC_STATUS_REG;
+
+    timeline_set_busy(TL_PHASE_RSP_TASK, !(*sp_status & SP_STATUS_HALTED));
+    timeline_set_busy(TL_PHASE_RDP_BATCH, (*dpc_status & (DPC_STATUS_CMD_BUSY | DPC_STATUS_PIPE_BUSY)) != 0);
+}
+
+// SP interrupts end RSP tasks, DP interrupts (SYNC_FULL) end RDP batches
+static void timeline_irq(void) {
+    timeline_poll();
+}
+
+void timeline_init(void) {
+    register_SP_handler(timeline_irq);
+    register_DP_handler(timeline_irq);
+}
+
+void timeline_frame_mark(void) {
+    timeline_poll();
+
+    disable_interrupts();
+    frame_prev = frame_cur;
+    frame_cur.index = ring_head;
+    frame_cur.count = read_c0_count();
+    memcpy(frame_cur.lane_state, lane_state, sizeof(lane_state));
+    enable_interrupts();
+
+    frames_marked++;
+}
+
+void timeline_begin(TimelinePhase phase) {
+    timeline_push(phase, 1);
+    timeline_poll();
+}
+
+void timeline_end(TimelinePhase phase) {
+    timeline_poll();
+    timeline_push(phase, 0);
+}
+
+int timeline_take_slices(TimelineSlice *out, int max) {
+    uint32_t open[TL_LANE_COUNT];
+    int n = 0;
+
+    if (frames_marked < 2 || frames_taken == frames_marked) {
+        return 0;
+    }
+    frames_taken = frames_marked;
+
+    disable_interrupts();
+    TimelineMark start = frame_prev;
+    TimelineMark end = frame_cur;
+    enable_interrupts();
+
+    if (end.index - start.index > TL_RING_SIZE) {
+        return 0;
+    }
+
+    uint8_t state[TL_LANE_COUNT];
+    memcpy(state, start.lane_state, sizeof(state));
+    for (int lane = 0; lane < TL_LANE_COUNT; lane++) {
+        open[lane] = start.count;
+    }
+
+    for (uint32_t i = start.index; i != end.index; i++) {
+        const TimelineEvent *ev = &ring[i & (TL_RING_SIZE - 1)];
+        if (ev->lane == TL_LANE_CPU) {
+            continue;
+        }
+        if (state[ev->lane] && n < max) {
+            out[n].phase = state[ev->lane] - 1;
+            out[n].start = open[ev->lane];
+            out[n].ticks = ev->count - open[ev->lane];
+            n++;
+        }
+        state[ev->lane] = ev->begin ? ev->phase + 1 : 0;
+        open[ev->lane] = ev->count;
+    }
+
+    // Still busy at the end of the frame
+    for (int lane = TL_LANE_RSP; lane < TL_LANE_COUNT; lane++) {
+        if (state[lane] && n < max) {
+            out[n].phase = state[lane] - 1;
+            out[n].start = open[lane];
+            out[n].ticks = end.count - open[lane];
+            n++;
+        }
+    }
+    return n;
+}
+
+void timeline_draw(display_context_t disp, int y) {
+    static uint8_t columns[TL_LANE_COUNT][TL_BAR_WIDTH];
+    char buffer[64];
+    int line_height = UI_LINE_HEIGHT;
+
+    ui_draw_text(disp, 15, y, "Frame Timeline (Real-Time)");
+    y += line_height + 2;
+
+    if (frames_marked < 2) {
+        return;
+    }
+
+    disable_interrupts();
+    TimelineMark start = frame_prev;
+    TimelineMark end = frame_cur;
+    enable_interrupts();
+
+    uint32_t frame_ticks = end.count - start.count;
+    uint32_t events = end.index - start.index;
+    if (frame_ticks == 0 || events > TL_RING_SIZE) {
+        ui_draw_text(disp, 20, y, "Ring buffer overrun");
+        return;
+    }
+
+    // Rasterize the frame's events into one column per bar pixel
+    int col[TL_LANE_COUNT] = {0};
+    uint8_t state[TL_LANE_COUNT];
+    memcpy(state, start.lane_state, sizeof(state));
+
+    for (uint32_t i = start.index; i != end.index; i++) {
+        const TimelineEvent *ev = &ring[i & (TL_RING_SIZE - 1)];
+        int x = (int)((uint64_t)(ev->count - start.count) * TL_BAR_WIDTH / frame_ticks);
+        if (x > TL_BAR_WIDTH) x = TL_BAR_WIDTH;
+
+        while (col[ev->lane] < x) {
+            columns[ev->lane][col[ev->lane]++] = state[ev->lane];
+        }
+        state[ev->lane] = ev->begin ? ev->phase + 1 : 0;
+    }
+    for (int lane = 0; lane < TL_LANE_COUNT; lane++) {
+        while (col[lane] < TL_BAR_WIDTH) {
+            columns[lane][col[lane]++] = state[lane];
+        }
+    }
+
+    // Draw each lane as runs of identical phases
+    int busy[TL_LANE_COUNT] = {0};
+    for (int lane = 0; lane < TL_LANE_COUNT; lane++) {
+        int lane_y = y + lane * (TL_LANE_H + TL_LANE_GAP);
+
+        ui_draw_text(disp, 15, lane_y + 1, lane_names[lane]);
+        ui_draw_box(disp, TL_BAR_X, lane_y, TL_BAR_WIDTH, TL_LANE_H, UI_COLOR_BAR);
+
+        int run_start = 0;
+        for (int x = 1; x <= TL_BAR_WIDTH; x++) {
+            if (x < TL_BAR_WIDTH && columns[lane][x] == columns[lane][run_start]) {
+                continue;
+            }
+            uint8_t s = columns[lane][run_start];
+            if (s) {
+                ui_draw_box(disp, TL_BAR_X + run_start, lane_y, x - run_start, TL_LANE_H, phase_colors[s - 1]);
+                busy[lane] += x - run_start;
+            }
+            run_start = x;
+        }
+    }
+    y += TL_LANE_COUNT * (TL_LANE_H + TL_LANE_GAP) + 2;
+
+    // Legend
+    int legend_x = 15;
+    for (int p = 0; p < TL_PHASE_COUNT; p++) {
+        ui_draw_box(disp, legend_x, y, 6, 8, phase_colors[p]);
+        ui_draw_text(disp, legend_x + 8, y, phase_names[p]);
+        legend_x += 10 + strlen(phase_names[p]) * 8 + 6;
+    }
+    y += line_height + 5;
+
+    // Overlap: columns where more than one processor was working
+    int any = 0, overlap = 0;
+    for (int x = 0; x < TL_BAR_WIDTH; x++) {
+        int n = (columns[TL_LANE_CPU][x] != 0) + (columns[TL_LANE_RSP][x] != 0) + (columns[TL_LANE_RDP][x] != 0);
+        if (n > 0) any++;
+        if (n > 1) overlap++;
+    }
+
+    fmt_str(fmt_float(buffer, (float)frame_ticks * 1000.0f / TICKS_PER_SECOND, 2), " ms");
+    draw_label_value(disp, 20, y, "Frame Period", buffer);
+    y += line_height;
+
+    for (int lane = 0; lane < TL_LANE_COUNT; lane++) {
+        char label[24];
+        fmt_str(fmt_str(label, lane_names[lane]), " Busy");
+        fmt_str(fmt_u32(buffer, (uint32_t)(busy[lane] * 100 / TL_BAR_WIDTH)), " %");
+        draw_label_value(disp, 20, y, label, buffer);
+        y += line_height;
+    }
+
+    fmt_str(fmt_u32(buffer, any ? (uint32_t)(overlap * 100 / any) : 0), " %");
+    draw_label_value(disp, 20, y, "Parallel (2+ busy)", buffer);
+    y += line_height;
+}
@@ -0,0 +1,58 @@
+#ifndef TIMELINE_H
+#define TIMELINE_H
+
+#include <libdragon.h>
+#include <stdint.h>
+
+// Processors shown as lanes of the per-frame Gantt bar
+typedef enum {
+    TL_LANE_CPU = 0,
+    TL_LANE_RSP,
+    TL_LANE_RDP,
+    TL_LANE_COUNT
+} TimelineLane;
+
+typedef enum {
+    TL_PHASE_UPDATE = 0,    // CPU: measurement snapshot
+    TL_PHASE_DRAW,          // CPU: drawing the frame
+    TL_PHASE_SHOW,          // CPU: display_show
+    TL_PHASE_RSP_TASK,      // RSP running (not halted)
+    TL_PHASE_RDP_BATCH,     // RDP processing commands
+    TL_PHASE_COUNT
+} TimelinePhase;
+
+// Ring buffer entry, timestamped with COUNT
+typedef struct {
+    uint32_t count;
+    uint8_t lane;
+    uint8_t phase;
+    uint8_t begin;
+} TimelineEvent;
+
+#define TL_RING_SIZE 512    // Must be a power of two
+
+// A phase interval, timestamped with COUNT
+typedef struct {
+    uint8_t phase;
+    uint32_t start;
+    uint32_t ticks;
+} TimelineSlice;
+
+// Registers the SP/DP callbacks that close RSP tasks and RDP batches
+void timeline_init(void);
+
+// Start a new frame; the previous one becomes available for drawing
+void timeline_frame_mark(void);
+
+// CPU phase boundaries (also sample RSP/RDP busy state)
+void timeline_begin(TimelinePhase phase);
+void timeline_end(TimelinePhase phase);
+
+// RSP and RDP intervals of the last complete frame, clipped to it. Returns
+// their number, 0 when that frame was already taken or overran the ring.
+int timeline_take_slices(TimelineSlice *out, int max);
+
+// Draw the last complete frame as a Gantt bar with overlap statistics
+void timeline_draw(display_context_t disp, int y);
+
+#endif /* TIMELINE_H */
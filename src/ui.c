@@ -0,0 +1,637 @@
+#include <libdragon.h>
+#include <string.h>
+
+#include "ui.h"
+#include "hw.h"
+#include "fmt.h"
+#include "text.h"
+
+// Incremental redraw state per framebuffer
+#define UI_MAX_BUFFERS  3
+#define UI_MAX_FIELDS   64
+#define UI_FIELD_CHARS  48            // More than a screen line (40 glyphs)
+#define UI_SCREEN_W     320
+
+// Pre-composited static content, one surface per recently used layout
+#define UI_BG_SLOTS     3
+
+typedef struct {
+    int16_t x, y;                   // x < 0: not cached, always redraw
+    uint8_t fg, bg;                 // A new color redraws the field too
+    char text[UI_FIELD_CHARS];
+} UiField;
+
+typedef struct {
+    const surface_t *surface;
+    uint32_t layout;
+    uint32_t generation;
+    UiField fields[UI_MAX_FIELDS];
+} UiBufferState;
+
+typedef struct {
+    surface_t surface;
+    uint32_t layout;
+    uint32_t generation;
+    uint32_t last_used;
+    int valid;
+} UiBackground;
+
+// Where static content (fills, boxes, labels) goes this frame
+typedef enum {
+    STATIC_SKIP = 0,    // Already on the framebuffer
+    STATIC_DRAW,        // Draw onto the framebuffer
+    STATIC_CAPTURE      // Draw into a new background surface
+} StaticMode;
+
+const char* ui_backend_names[UI_BACKEND_COUNT] = {
+    "CPU",
+    "RDP"
+};
+
+const char* ui_redraw_names[UI_REDRAW_COUNT] = {
+    "Full",
+    "Incremental"
+};
+
+const char* ui_background_names[UI_BACKGROUND_COUNT] = {
+    "Off",
+    "Cached"
+};
+
+const char* ui_text_names[UI_TEXT_COUNT] = {
+    "Direct",
+    "Batched",
+    "Packed"
+};
+
+const char* ui_depth_names[UI_DEPTH_COUNT] = {
+    "32-bit",
+    "16-bit"
+};
+
+const char* ui_acquire_names[UI_ACQUIRE_COUNT] = {
+    "Spin x2",
+    "Wait x3"
+};
+
+const char* ui_render_rate_names[UI_RENDER_COUNT] = {
+    "Every VI",
+    "Every 2nd VI"
+};
+
+// Palette in RGBA8888, indexed by UiColor
+static const uint32_t palette_rgba[UI_COLOR_COUNT] = {
+    [UI_COLOR_BACKGROUND] = 0x1A1A2EFF,
+    [UI_COLOR_TEXT]       = 0xFFFFFFFF,
+    [UI_COLOR_BAR]        = 0x2D2D44FF,
+    [UI_COLOR_HIGHLIGHT]  = 0x4A4A6AFF,
+    [UI_COLOR_BLUE]       = 0x4FA3E0FF,
+    [UI_COLOR_GREEN]      = 0x6CCB5FFF,
+    [UI_COLOR_YELLOW]     = 0xE0C04FFF,
+    [UI_COLOR_RED]        = 0xD9534FFF,
+    [UI_COLOR_PURPLE]     = 0xB06FD9FF,
+    [UI_COLOR_CYAN]       = 0x4FD1C5FF,
+    [UI_COLOR_ORANGE]     = 0xE08A4FFF,
+};
+
+static UiBackend requested_backend = UI_BACKEND_CPU;
+static UiBackend backend = UI_BACKEND_CPU;
+static UiTextEngine text_engine = UI_TEXT_BATCHED;
+static UiColor text_fg = UI_COLOR_TEXT;
+static UiColor text_bg = UI_COLOR_BACKGROUND;
+
+// Palette converted for the current display mode: graphics_* take colors in
+// the framebuffer format, rdpq takes color_t and converts on the RSP
+static UiDepth requested_depth = UI_DEPTH_32;
+static UiDepth depth = UI_DEPTH_32;
+static int display_ready = 0;
+static uint32_t palette_native[UI_COLOR_COUNT];
+static color_t palette_rdp[UI_COLOR_COUNT];
+
+static UiAcquire requested_acquire = UI_ACQUIRE_SPIN;
+static UiAcquire acquire = UI_ACQUIRE_SPIN;
+static volatile int vi_pending = 0;
+static volatile uint32_t vi_count = 0;
+static uint32_t last_render_vi = 0;
+static UiRenderRate render_rate = UI_RENDER_FULL;
+static float wait_us[UI_ACQUIRE_COUNT];
+static float rcp_polls[UI_ACQUIRE_COUNT];
+
+static UiRedraw redraw = UI_REDRAW_INCREMENTAL;
+static UiBufferState buffer_states[UI_MAX_BUFFERS];
+static UiBufferState *current = NULL;
+static uint32_t generation = 1;
+static int next_state = 0;
+static StaticMode static_mode = STATIC_DRAW;
+static int full_repaint = 1;
+static int field_index = 0;
+static int fields_redrawn = 0;
+static int fields_redrawn_last = 0;
+
+static UiBackgroundMode background_mode = UI_BACKGROUND_CACHED;
+static UiBackground backgrounds[UI_BG_SLOTS];
+static UiBackground *capture = NULL;
+static display_context_t current_disp = NULL;
+static uint32_t use_clock = 0;
+static int defer_fields = 0;
+
+// Exponential moving average of CPU time per frame, per backend
+static float cpu_us[UI_BACKEND_COUNT];
+static uint32_t frame_start = 0;
+
+static void vi_callback(void) {
+    vi_pending = 1;
+    vi_count++;
+}
+
+void ui_init(void) {
+    text_init();
+    text_set_palette(palette_rgba, UI_COLOR_COUNT);
+    ui_set_color(UI_COLOR_TEXT, UI_COLOR_BACKGROUND);
+    register_VI_handler(vi_callback);
+}
+
+void ui_display_init(void) {
+    if (display_ready) {
+        // The RDP may still be drawing into a buffer that is about to go
+        rspq_wait();
+        display_close();
+    }
+
+    depth = requested_depth;
+    acquire = requested_acquire;
+    display_init(RESOLUTION_320x240, depth == UI_DEPTH_16 ? DEPTH_16_BPP : DEPTH_32_BPP,
+                 acquire == UI_ACQUIRE_WAIT ? 3 : 2, GAMMA_NONE, ANTIALIAS_RESAMPLE);
+    display_ready = 1;
+
+    for (int i = 0; i < UI_COLOR_COUNT; i++) {
+        palette_rdp[i] = color_from_packed32(palette_rgba[i]);
+        palette_native[i] = graphics_convert_color(palette_rdp[i]);
+    }
+    text_set_palette(palette_rgba, UI_COLOR_COUNT);
+
+    // New framebuffers: nothing valid on them, cached backgrounds mismatch
+    ui_set_color(text_fg, text_bg);
+    ui_invalidate();
+}
+
+void ui_set_depth(UiDepth d) {
+    requested_depth = d;
+}
+
+UiDepth ui_get_depth(void) {
+    return requested_depth;
+}
+
+UiDepth ui_display_depth(void) {
+    return depth;
+}
+
+void ui_set_acquire(UiAcquire mode) {
+    requested_acquire = mode;
+}
+
+UiAcquire ui_get_acquire(void) {
+    return requested_acquire;
+}
+
+int ui_display_pending(void) {
+    return requested_depth != depth || requested_acquire != acquire;
+}
+
+void ui_set_render_rate(UiRenderRate rate) {
+    render_rate = rate;
+}
+
+UiRenderRate ui_get_render_rate(void) {
+    return render_rate;
+}
+
+// Idle until the VI callback sets the flag. The VR4300 has no WAIT
+// instruction and libdragon has no scheduler to yield to, so the CPU cannot
+// halt until an interrupt; display_get() also loops over display_try_get().
+// The cheapest idle left is a load that hits the data cache: no RCP or RDRAM
+// traffic, and the VI handler runs as soon as the interrupt arrives.
+static void idle_until_vi(void) {
+    while (!vi_pending);
+}
+
+static void average(float *avg, float value) {
+    *avg = (*avg == 0.0f) ? value : *avg * 0.9f + value * 0.1f;
+}
+
+display_context_t ui_acquire(void) {
+    display_context_t disp;
+    uint32_t polls = 0;
+
+    // At half rate, let a second vertical interval pass since the previous
+    // frame. This is pacing, not waiting for a buffer, so it is not timed.
+    if (render_rate == UI_RENDER_HALF) {
+        while (vi_count - last_render_vi < 2) {
+            vi_pending = 0;
+            if (vi_count - last_render_vi < 2) {
+                idle_until_vi();
+            }
+        }
+    }
+    last_render_vi = vi_count;
+
+    uint32_t start = read_c0_count();
+
+    if (acquire == UI_ACQUIRE_SPIN) {
+        do {
+            polls++;
+        } while (!(disp = display_lock()));
+    } else {
+        // A buffer can only become free at a vertical interrupt, so there is
+        // one attempt per interrupt. The flag is cleared before each attempt
+        // so an interrupt that lands in between is not lost.
+        for (;;) {
+            vi_pending = 0;
+            polls++;
+            if ((disp = display_try_get())) {
+                break;
+            }
+            idle_until_vi();
+        }
+    }
+
+    average(&wait_us[acquire], (float)(read_c0_count() - start) * 1000000.0f / TICKS_PER_SECOND);
+    average(&rcp_polls[acquire], (float)polls);
+    return disp;
+}
+
+float ui_rcp_polls(UiAcquire mode) {
+    return rcp_polls[mode];
+}
+
+float ui_wait_time_us(UiAcquire mode) {
+    return wait_us[mode];
+}
+
+void ui_set_color(UiColor fg, UiColor bg) {
+    text_fg = fg;
+    text_bg = bg;
+    text_set_color(fg, bg);
+    graphics_set_color(palette_native[fg], 0x00000000);
+}
+
+void ui_set_backend(UiBackend b) {
+    requested_backend = b;
+    ui_invalidate();
+}
+
+UiBackend ui_get_backend(void) {
+    return requested_backend;
+}
+
+void ui_set_redraw(UiRedraw r) {
+    redraw = r;
+    ui_invalidate();
+}
+
+UiRedraw ui_get_redraw(void) {
+    return redraw;
+}
+
+void ui_set_background_mode(UiBackgroundMode mode) {
+    background_mode = mode;
+    ui_invalidate();
+}
+
+UiBackgroundMode ui_get_background_mode(void) {
+    return background_mode;
+}
+
+void ui_set_text_engine(UiTextEngine engine) {
+    text_engine = engine;
+    ui_invalidate();
+}
+
+UiTextEngine ui_get_text_engine(void) {
+    return text_engine;
+}
+
+void ui_invalidate(void) {
+    generation++;
+}
+
+static void draw_box(display_context_t disp, int x, int y, int width, int height, UiColor color) {
+    if (backend == UI_BACKEND_RDP) {
+        rdpq_set_mode_fill(palette_rdp[color]);
+        rdpq_fill_rectangle(x, y, x + width, y + height);
+    } else {
+        graphics_draw_box(disp, x, y, width, height, palette_native[color]);
+    }
+}
+
+// Erase a field's text, clipped to the right edge of the screen
+static void erase_field(display_context_t disp, int x, int y, int chars, UiColor color) {
+    int width = chars * 8;
+    if (x + width > UI_SCREEN_W) {
+        width = UI_SCREEN_W - x;
+    }
+    if (width > 0) {
+        draw_box(disp, x, y, width, 8, color);
+    }
+}
+
+static void draw_text(display_context_t disp, int x, int y, const char* text) {
+    // Batched text is emitted at ui_end(), on top of everything else
+    if (text_engine == UI_TEXT_BATCHED) {
+        text_queue(x, y, text);
+    } else if (backend == UI_BACKEND_RDP) {
+        text_draw_direct(x, y, text);
+    } else if (text_engine == UI_TEXT_PACKED) {
+        text_draw_packed(disp, x, y, text);
+    } else {
+        graphics_draw_text(disp, x, y, text);
+    }
+}
+
+static int background_matches(const UiBackground *bg, const surface_t *disp) {
+    return bg->surface.buffer != NULL &&
+           bg->surface.width == disp->width &&
+           bg->surface.height == disp->height &&
+           surface_get_format(&bg->surface) == surface_get_format(disp);
+}
+
+static UiBackground* background_lookup(const surface_t *disp, uint32_t layout) {
+    for (int i = 0; i < UI_BG_SLOTS; i++) {
+        UiBackground *bg = &backgrounds[i];
+        if (bg->valid && bg->layout == layout && bg->generation == generation &&
+            background_matches(bg, disp)) {
+            bg->last_used = ++use_clock;
+            return bg;
+        }
+    }
+    return NULL;
+}
+
+// Take the least recently used slot and (re)allocate its surface if needed
+static UiBackground* background_alloc(const surface_t *disp, uint32_t layout) {
+    UiBackground *bg = &backgrounds[0];
+    for (int i = 1; i < UI_BG_SLOTS; i++) {
+        if (backgrounds[i].last_used < bg->last_used) {
+            bg = &backgrounds[i];
+        }
+    }
+
+    if (!background_matches(bg, disp)) {
+        if (bg->surface.buffer) {
+            surface_free(&bg->surface);
+        }
+        bg->surface = surface_alloc(surface_get_format(disp), disp->width, disp->height);
+        if (!bg->surface.buffer) {
+            return NULL;
+        }
+    }
+
+    bg->layout = layout;
+    bg->generation = generation;
+    bg->last_used = ++use_clock;
+    bg->valid = 0;
+    return bg;
+}
+
+// One RDP blit of the whole background; the CPU backend waits for it
+static void copy_background(display_context_t disp, const surface_t *bg) {
+    if (backend != UI_BACKEND_RDP) {
+        rdpq_attach(disp, NULL);
+    }
+
+    rdpq_set_mode_standard();
+    rdpq_mode_combiner(RDPQ_COMBINER_TEX);
+    rdpq_tex_blit(bg, 0, 0, NULL);
+
+    if (backend != UI_BACKEND_RDP) {
+        rdpq_detach_wait();
+    }
+}
+
+static UiBufferState* buffer_state(const surface_t *surface) {
+    for (int i = 0; i < UI_MAX_BUFFERS; i++) {
+        if (buffer_states[i].surface == surface) {
+            return &buffer_states[i];
+        }
+    }
+
+    // First time this framebuffer is seen: nothing valid on it yet
+    UiBufferState *state = &buffer_states[next_state];
+    next_state = (next_state + 1) % UI_MAX_BUFFERS;
+    state->surface = surface;
+    state->generation = 0;
+    return state;
+}
+
+void ui_begin(display_context_t disp, uint32_t layout) {
+    backend = requested_backend;
+    frame_start = read_c0_count();
+
+    current = buffer_state(disp);
+    current_disp = disp;
+    full_repaint = (redraw == UI_REDRAW_FULL) ||
+                   (layout & UI_LAYOUT_DYNAMIC) ||
+                   current->layout != layout ||
+                   current->generation != generation;
+    current->layout = layout;
+    current->generation = generation;
+    field_index = 0;
+    fields_redrawn_last = fields_redrawn;
+    fields_redrawn = 0;
+
+    static_mode = full_repaint ? STATIC_DRAW : STATIC_SKIP;
+    defer_fields = 0;
+    capture = NULL;
+
+    if (backend == UI_BACKEND_RDP) {
+        rdpq_attach(disp, NULL);
+    }
+
+    // A full repaint starts from the cached background when there is one;
+    // otherwise this frame's static content is captured into a new one
+    if (full_repaint && background_mode == UI_BACKGROUND_CACHED && !(layout & UI_LAYOUT_DYNAMIC)) {
+        UiBackground *bg = background_lookup(disp, layout);
+        if (bg) {
+            copy_background(disp, &bg->surface);
+            static_mode = STATIC_SKIP;
+        } else {
+            capture = background_alloc(disp, layout);
+            if (capture) {
+                static_mode = STATIC_CAPTURE;
+                defer_fields = 1;
+            }
+        }
+    }
+}
+
+void ui_end(void) {
+    // Fields were held back until the captured background is on screen
+    if (capture) {
+        capture->valid = 1;
+        data_cache_hit_writeback(capture->surface.buffer,
+                                 capture->surface.stride * capture->surface.height);
+        copy_background(current_disp, &capture->surface);
+        UiColor fg = text_fg, bg = text_bg;
+        for (int i = 0; i < field_index; i++) {
+            const UiField *field = &current->fields[i];
+            if (field->x >= 0) {
+                ui_set_color(field->fg, field->bg);
+                draw_text(current_disp, field->x, field->y, field->text);
+            }
+        }
+        ui_set_color(fg, bg);
+        capture = NULL;
+    }
+
+    // One RDP pass for all of the frame's text, also with the CPU backend
+    if (text_queued()) {
+        if (backend != UI_BACKEND_RDP) {
+            rdpq_attach(current_disp, NULL);
+        }
+        text_flush();
+        if (backend != UI_BACKEND_RDP) {
+            rdpq_detach_wait();
+        }
+    }
+
+    uint32_t ticks = read_c0_count() - frame_start;
+    float us = (float)ticks * 1000000.0f / TICKS_PER_SECOND;
+
+    if (cpu_us[backend] == 0.0f) {
+        cpu_us[backend] = us;
+    } else {
+        cpu_us[backend] = cpu_us[backend] * 0.9f + us * 0.1f;
+    }
+}
+
+void ui_show(display_context_t disp) {
+    if (backend == UI_BACKEND_RDP) {
+        // Scanout switches once the RDP has finished the frame
+        rdpq_detach_show();
+    } else {
+        display_show(disp);
+    }
+}
+
+void ui_fill_screen(display_context_t disp, UiColor color) {
+    if (static_mode == STATIC_SKIP) {
+        return;
+    }
+    if (static_mode == STATIC_CAPTURE) {
+        graphics_fill_screen(&capture->surface, palette_native[color]);
+    } else if (backend == UI_BACKEND_RDP) {
+        rdpq_set_mode_fill(palette_rdp[color]);
+        rdpq_fill_rectangle(0, 0, disp->width, disp->height);
+    } else {
+        graphics_fill_screen(disp, palette_native[color]);
+    }
+}
+
+void ui_draw_box(display_context_t disp, int x, int y, int width, int height, UiColor color) {
+    if (static_mode == STATIC_CAPTURE) {
+        graphics_draw_box(&capture->surface, x, y, width, height, palette_native[color]);
+    } else if (static_mode == STATIC_DRAW) {
+        draw_box(disp, x, y, width, height, color);
+    }
+}
+
+void ui_draw_text(display_context_t disp, int x, int y, const char* text) {
+    if (static_mode == STATIC_CAPTURE) {
+        graphics_draw_text(&capture->surface, x, y, text);
+    } else if (static_mode == STATIC_DRAW) {
+        draw_text(disp, x, y, text);
+    }
+}
+
+void ui_blit(display_context_t disp, const surface_t *surf, int x, int y, int s0, int width) {
+    if (backend != UI_BACKEND_RDP) {
+        rdpq_attach(disp, NULL);
+    }
+
+    rdpq_set_mode_standard();
+    rdpq_mode_combiner(RDPQ_COMBINER_TEX);
+    rdpq_tex_blit(surf, x, y, &(rdpq_blitparms_t){ .s0 = s0, .width = width });
+
+    if (backend != UI_BACKEND_RDP) {
+        rdpq_detach_wait();
+    }
+}
+
+color_t ui_palette(UiColor color) {
+    return color_from_packed32(palette_rgba[color]);
+}
+
+void ui_draw_overlay(display_context_t disp, int x, int y, int width, int height, UiColor color) {
+    draw_box(disp, x, y, width, height, color);
+}
+
+void ui_draw_field(display_context_t disp, int x, int y, const char* text) {
+    if (field_index >= UI_MAX_FIELDS) {
+        // Out of slots: nothing to compare against, so the field is erased
+        // and drawn on every frame. While a background is being captured it
+        // goes into the capture, and later frames draw over it.
+        if (static_mode == STATIC_CAPTURE) {
+            ui_draw_text(disp, x, y, text);
+        } else {
+            erase_field(disp, x, y, UI_FIELD_CHARS, text_bg);
+            draw_text(disp, x, y, text);
+        }
+        fields_redrawn++;
+        return;
+    }
+
+    UiField *field = &current->fields[field_index++];
+    int len = strlen(text);
+
+    if (!full_repaint) {
+        if (field->x == x && field->y == y && field->fg == text_fg && field->bg == text_bg &&
+            strcmp(field->text, text) == 0) {
+            return;
+        }
+
+        // Erase the old text before drawing the new one. Unknown old text
+        // may reach the screen edge; text that moved is erased where it was.
+        if (field->x < 0) {
+            erase_field(disp, x, y, UI_FIELD_CHARS, text_bg);
+        } else if (field->x != x || field->y != y) {
+            erase_field(disp, field->x, field->y, strlen(field->text), field->bg);
+            erase_field(disp, x, y, len, text_bg);
+        } else {
+            int old_len = strlen(field->text);
+            erase_field(disp, x, y, (len > old_len) ? len : old_len, text_bg);
+        }
+    }
+
+    if (!defer_fields) {
+        draw_text(disp, x, y, text);
+    }
+    fields_redrawn++;
+
+    if (len < UI_FIELD_CHARS) {
+        field->x = x;
+        field->y = y;
+        field->fg = text_fg;
+        field->bg = text_bg;
+        memcpy(field->text, text, len + 1);
+    } else {
+        field->x = -1;
+        field->text[0] = '\0';
+    }
+}
+
+int ui_fields_redrawn(void) {
+    return fields_redrawn_last;
+}
+
+float ui_cpu_time_us(UiBackend b) {
+    return cpu_us[b];
+}
+
+// Draw a labeled value
+void draw_label_value(display_context_t disp, int x, int y, const char* label, const char* value) {
+    char buffer[64];
+    int len = fmt_str(fmt_pad(buffer, label, 20), " : ") - buffer;
+    ui_draw_text(disp, x, y, buffer);
+    ui_draw_field(disp, x + len * 8, y, value);
+}
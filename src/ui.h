@@ -0,0 +1,192 @@
+#ifndef UI_H
+#define UI_H
+
+#include <libdragon.h>
+
+// Common layout metrics shared by all tabs
+#define UI_LINE_HEIGHT 11
+#define UI_CONTENT_Y   50
+
+// UI palette. Colors are passed by index; their framebuffer values are
+// converted once per display mode instead of on every draw.
+typedef enum {
+    UI_COLOR_BACKGROUND = 0,    // Screen background, also used to erase changed fields
+    UI_COLOR_TEXT,
+    UI_COLOR_BAR,               // Title and status bars, inactive tabs
+    UI_COLOR_HIGHLIGHT,         // Active tab, selected row
+    UI_COLOR_BLUE,
+    UI_COLOR_GREEN,
+    UI_COLOR_YELLOW,
+    UI_COLOR_RED,
+    UI_COLOR_PURPLE,
+    UI_COLOR_CYAN,
+    UI_COLOR_ORANGE,
+    UI_COLOR_COUNT
+} UiColor;
+
+// Framebuffer depth. 16-bit halves the memory and the VI scanout and
+// clear bandwidth of every buffer.
+typedef enum {
+    UI_DEPTH_32 = 0,
+    UI_DEPTH_16,
+    UI_DEPTH_COUNT
+} UiDepth;
+
+extern const char* ui_depth_names[UI_DEPTH_COUNT];
+
+// Frame acquisition: Spin polls display_lock() with two buffers; Wait uses
+// three buffers and sleeps until a vertical interrupt frees one
+typedef enum {
+    UI_ACQUIRE_SPIN = 0,
+    UI_ACQUIRE_WAIT,
+    UI_ACQUIRE_COUNT
+} UiAcquire;
+
+extern const char* ui_acquire_names[UI_ACQUIRE_COUNT];
+
+// Render rate as a divider of the vertical interrupt rate. Measurements are
+// sampled on their own timer, so this only changes how often they are drawn.
+typedef enum {
+    UI_RENDER_FULL = 0,
+    UI_RENDER_HALF,
+    UI_RENDER_COUNT
+} UiRenderRate;
+
+extern const char* ui_render_rate_names[UI_RENDER_COUNT];
+
+// Renderer backends: CPU draws with graphics_*, RDP issues everything
+// through rdpq so the CPU only builds the command list
+typedef enum {
+    UI_BACKEND_CPU = 0,
+    UI_BACKEND_RDP,
+    UI_BACKEND_COUNT
+} UiBackend;
+
+extern const char* ui_backend_names[UI_BACKEND_COUNT];
+
+// Redraw policy: full repaints every frame; incremental draws static
+// content once per framebuffer and afterwards only fields whose text changed
+typedef enum {
+    UI_REDRAW_FULL = 0,
+    UI_REDRAW_INCREMENTAL,
+    UI_REDRAW_COUNT
+} UiRedraw;
+
+extern const char* ui_redraw_names[UI_REDRAW_COUNT];
+
+// Static content of a layout can be pre-composited into a background
+// surface; a full repaint then starts with one RDP copy of it
+typedef enum {
+    UI_BACKGROUND_OFF = 0,
+    UI_BACKGROUND_CACHED,
+    UI_BACKGROUND_COUNT
+} UiBackgroundMode;
+
+extern const char* ui_background_names[UI_BACKGROUND_COUNT];
+
+// Text engine: Direct draws each string immediately (graphics_* or one RDP
+// blit per glyph); Batched queues glyphs and emits them from a TMEM-resident
+// atlas in one rdpq stream at ui_end(); Packed expands a 1bpp font with
+// 64-bit CPU stores (CPU backend only, Direct with the RDP backend)
+typedef enum {
+    UI_TEXT_DIRECT = 0,
+    UI_TEXT_BATCHED,
+    UI_TEXT_PACKED,
+    UI_TEXT_COUNT
+} UiTextEngine;
+
+extern const char* ui_text_names[UI_TEXT_COUNT];
+
+// Layout flag: static content changes every frame (never cached)
+#define UI_LAYOUT_DYNAMIC 0x80000000
+
+// (Re)initialize the display (320x240) with the requested depth and
+// buffer count and convert the palette for it. Call between frames only.
+void ui_display_init(void);
+
+// Build the RDP glyph atlases (call once after ui_display_init and rdpq_init)
+void ui_init(void);
+
+// Requested depth, applied by the next ui_display_init()
+void ui_set_depth(UiDepth depth);
+UiDepth ui_get_depth(void);
+UiDepth ui_display_depth(void);
+
+void ui_set_acquire(UiAcquire mode);
+UiAcquire ui_get_acquire(void);
+
+// A requested display setting is waiting for ui_display_init()
+int ui_display_pending(void);
+
+void ui_set_render_rate(UiRenderRate rate);
+UiRenderRate ui_get_render_rate(void);
+
+// Next free framebuffer, acquired in the active mode once the render
+// interval has passed
+display_context_t ui_acquire(void);
+
+// Average time per frame spent waiting for a framebuffer, per mode
+float ui_wait_time_us(UiAcquire mode);
+// Average framebuffer attempts per frame; each one reads RCP state
+float ui_rcp_polls(UiAcquire mode);
+
+// Takes effect from the next ui_begin()
+void ui_set_backend(UiBackend backend);
+UiBackend ui_get_backend(void);
+
+void ui_set_redraw(UiRedraw redraw);
+UiRedraw ui_get_redraw(void);
+
+void ui_set_background_mode(UiBackgroundMode mode);
+UiBackgroundMode ui_get_background_mode(void);
+
+void ui_set_text_engine(UiTextEngine engine);
+UiTextEngine ui_get_text_engine(void);
+
+// Force a full repaint of every framebuffer (static content changed)
+void ui_invalidate(void);
+
+// Frame bracket: every ui_* draw call must happen between begin and end.
+// layout identifies the static content (tab, page, ...): a framebuffer that
+// last showed another layout is repainted in full.
+void ui_begin(display_context_t disp, uint32_t layout);
+void ui_end(void);
+void ui_show(display_context_t disp);
+
+// Text colors, mirroring graphics_set_color. The background is what the
+// text is drawn over: Packed text fills it in and changed fields are erased
+// with it. Restore UI_COLOR_BACKGROUND after drawing on a colored box.
+void ui_set_color(UiColor fg, UiColor bg);
+
+// Drawing primitives, mirroring graphics_* (colors are palette indices).
+// These draw static content and are skipped on incremental frames.
+void ui_fill_screen(display_context_t disp, UiColor color);
+void ui_draw_box(display_context_t disp, int x, int y, int width, int height, UiColor color);
+void ui_draw_text(display_context_t disp, int x, int y, const char* text);
+
+// Dynamic text: redrawn only when it differs from what this framebuffer shows.
+// Fields are matched by call order within the frame.
+void ui_draw_field(display_context_t disp, int x, int y, const char* text);
+
+// RDP blit of columns [s0, s0 + width) of an RGBA16 surface to (x, y).
+// Drawn on every frame, even incremental ones, so use it on dynamic layouts.
+void ui_blit(display_context_t disp, const surface_t *surf, int x, int y, int s0, int width);
+
+// Palette entry as a color, e.g. for drawing into offscreen surfaces
+color_t ui_palette(UiColor color);
+
+// Overlay box, drawn every frame between ui_end() and ui_show() so that it
+// lands on top of the batched text. Never cached; callers repaint the same
+// area each frame.
+void ui_draw_overlay(display_context_t disp, int x, int y, int width, int height, UiColor color);
+
+// Fields redrawn in the last frame
+int ui_fields_redrawn(void);
+
+// Average CPU time per frame spent issuing the UI, per backend (0 = not measured yet)
+float ui_cpu_time_us(UiBackend backend);
+
+// Draw a "label : value" row (static label, value as a field)
+void draw_label_value(display_context_t disp, int x, int y, const char* label, const char* value);
+
+#endif /* UI_H */
@@ -0,0 +1,72 @@
+#include <assert.h>
+#include <stdio.h>
+
+#include "baseline.h"
+
+#define REF(value) { [BASELINE_CPU_MHZ] = { value, 1.0f, 3.0f, 0 } }
+
+static const BaselineEntry table[] = {
+    { "Generic",     0,          BASELINE_ANY_REGION, 0, REF(1.0f) },
+    { "NTSC",        0,          BASELINE_NTSC,       0, REF(2.0f) },
+    { "NTSC 8 MB",   0,          BASELINE_NTSC,       8, REF(3.0f) },
+    { "Rev 2",       0x02020102, BASELINE_ANY_REGION, 0, REF(4.0f) },
+    { "PAL",         0,          BASELINE_PAL,        0, REF(5.0f) },
+    { "PAL again",   0,          BASELINE_PAL,        0, REF(6.0f) },
+};
+
+#define TABLE_COUNT (int)(sizeof(table) / sizeof(table[0]))
+
+static BaselineVerdict verdict(float expected, int low_only, float value) {
+    BaselineRef ref = { expected, 5.0f, 20.0f, (uint8_t)low_only };
+    return baseline_check(&ref, value).verdict;
+}
+
+int main(void) {
+    printf("Testing entry selection...\n");
+    assert(baseline_find(table, TABLE_COUNT, 0x01010101, BASELINE_NTSC, 4) == &table[1]);
+    assert(baseline_find(table, TABLE_COUNT, 0x01010101, BASELINE_NTSC, 8) == &table[2]);
+    assert(baseline_find(table, TABLE_COUNT, 0x01010101, BASELINE_MPAL, 4) == &table[0]);
+    // The revision outranks region and RAM size
+    assert(baseline_find(table, TABLE_COUNT, 0x02020102, BASELINE_NTSC, 8) == &table[3]);
+    // Equally specific entries: the first one wins
+    assert(baseline_find(table, TABLE_COUNT, 0x01010101, BASELINE_PAL, 4) == &table[4]);
+    // Without a catch-all entry nothing may match
+    assert(baseline_find(table + 1, TABLE_COUNT - 1, 0, BASELINE_MPAL, 4) == NULL);
+
+    printf("Testing the built-in table...\n");
+    for (int region = BASELINE_NTSC; region <= BASELINE_ANY_REGION; region++) {
+        const BaselineEntry *e = baseline_select(0, (BaselineRegion)region, 4);
+        assert(e != NULL);
+        for (int m = 0; m < BASELINE_METRIC_COUNT; m++) {
+            const BaselineRef *ref = &e->refs[m];
+            assert(ref->expected > 0.0f);
+            assert(ref->warn_pct > 0.0f && ref->warn_pct < ref->fail_pct);
+            // A console exactly on its reference passes
+            assert(baseline_check(ref, ref->expected).verdict == BASELINE_PASS);
+        }
+    }
+    assert(baseline_select(0, BASELINE_PAL, 8)->refs[BASELINE_REFRESH].expected == 50.0f);
+    assert(baseline_select(0, BASELINE_NTSC, 4)->refs[BASELINE_REFRESH].expected == 60.0f);
+
+    printf("Testing verdicts...\n");
+    assert(verdict(100.0f, 0, 100.0f) == BASELINE_PASS);
+    assert(verdict(100.0f, 0, 104.0f) == BASELINE_PASS);
+    assert(verdict(100.0f, 0, 94.0f) == BASELINE_WARN);
+    assert(verdict(100.0f, 0, 110.0f) == BASELINE_WARN);
+    assert(verdict(100.0f, 0, 79.0f) == BASELINE_FAIL);
+    assert(verdict(100.0f, 0, 125.0f) == BASELINE_FAIL);
+    // Only a shortfall counts when more is never worse
+    assert(verdict(100.0f, 1, 150.0f) == BASELINE_PASS);
+    assert(verdict(100.0f, 1, 70.0f) == BASELINE_FAIL);
+    // Nothing measured yet, or nothing to compare against
+    assert(verdict(100.0f, 0, 0.0f) == BASELINE_UNCHECKED);
+    assert(verdict(0.0f, 0, 100.0f) == BASELINE_UNCHECKED);
+
+    BaselineRef ref = { 93.75f, 1.0f, 3.0f, 0 };
+    BaselineCheck check = baseline_check(&ref, 93.0f);
+    assert(check.deviation_pct > -0.8001f && check.deviation_pct < -0.7999f);
+    assert(check.verdict == BASELINE_PASS);
+
+    printf("All baseline tests passed!\n");
+    return 0;
+}
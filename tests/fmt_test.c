@@ -0,0 +1,94 @@
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "fmt.h"
+
+static void check_u32(uint32_t value) {
+    char expected[FMT_MAX];
+    char actual[FMT_MAX];
+    snprintf(expected, sizeof(expected), "%lu", (unsigned long)value);
+    char *end = fmt_u32(actual, value);
+    assert(strcmp(actual, expected) == 0);
+    assert(end == actual + strlen(expected));
+}
+
+static void check_float(float value, int decimals) {
+    char expected[FMT_MAX];
+    char actual[FMT_MAX];
+    snprintf(expected, sizeof(expected), "%.*f", decimals, value);
+    fmt_float(actual, value, decimals);
+    assert(strcmp(actual, expected) == 0);
+}
+
+static void check_hex(uint32_t value) {
+    char expected[FMT_MAX];
+    char actual[FMT_MAX];
+    snprintf(expected, sizeof(expected), "0x%08lX", (unsigned long)value);
+    fmt_hex32(actual, value);
+    assert(strcmp(actual, expected) == 0);
+}
+
+int main(void) {
+    char buffer[64];
+
+    printf("Testing fmt_u32()...\n");
+    check_u32(0);
+    check_u32(7);
+    check_u32(10);
+    check_u32(4096);
+    check_u32(93750000);
+    check_u32(UINT32_MAX);
+
+    printf("Testing fmt_fixed()...\n");
+    fmt_fixed(buffer, 9375, 2);
+    assert(strcmp(buffer, "93.75") == 0);
+    fmt_fixed(buffer, 5, 2);
+    assert(strcmp(buffer, "0.05") == 0);
+    fmt_fixed(buffer, -1205, 1);
+    assert(strcmp(buffer, "-120.5") == 0);
+    fmt_fixed(buffer, 42, 0);
+    assert(strcmp(buffer, "42") == 0);
+    fmt_fixed(buffer, INT32_MIN, 0);
+    assert(strcmp(buffer, "-2147483648") == 0);
+
+    printf("Testing fmt_float()...\n");
+    check_float(0.0f, 2);
+    check_float(93.75f, 2);
+    check_float(62.5f, 1);
+    check_float(59.826f, 1);
+    check_float(0.004f, 2);
+    check_float(-0.001f, 2);
+    check_float(-12.34f, 2);
+    check_float(187.5f, 0);
+    check_float(1.0f / 3.0f, 4);
+
+    printf("Testing fmt_hex32()...\n");
+    check_hex(0);
+    check_hex(0x0B22);
+    check_hex(0xDEADBEEF);
+
+    printf("Testing fmt_mhz() and fmt_mbps()...\n");
+    fmt_mhz(buffer, 93.75f);
+    assert(strcmp(buffer, "93.75 MHz") == 0);
+    fmt_mbps(buffer, 500);
+    assert(strcmp(buffer, "500 MB/s") == 0);
+
+    printf("Testing padding and chaining...\n");
+    char *end = fmt_str(fmt_pad(buffer, "Core Speed", 20), " : ");
+    snprintf(buffer + 32, 32, "%-20s : ", "Core Speed");
+    assert(strcmp(buffer, buffer + 32) == 0);
+    assert(end - buffer == 23);
+
+    fmt_pad(buffer, "A very long label here", 4);
+    assert(strcmp(buffer, "A very long label here") == 0);
+
+    fmt_rjust(buffer, "42", 5);
+    assert(strcmp(buffer, "   42") == 0);
+    fmt_rjust(buffer, "123456", 3);
+    assert(strcmp(buffer, "123456") == 0);
+
+    printf("All tests passed!\n");
+    return 0;
+}
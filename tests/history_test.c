@@ -0,0 +1,104 @@
+#include <assert.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "history.h"
+
+static History history;
+
+static void record(float value, uint32_t now_ms) {
+    float values[HISTORY_METRIC_COUNT];
+    for (int m = 0; m < HISTORY_METRIC_COUNT; m++) {
+        values[m] = value + m;
+    }
+    history_record(&history, values, now_ms);
+}
+
+static int near(float a, float b) {
+    return fabsf(a - b) < 0.001f;
+}
+
+int main(void) {
+    const HistorySample *s;
+
+    printf("Testing frame ring...\n");
+    history_init(&history);
+    assert(history_count(&history, HISTORY_FRAME) == 0);
+    assert(history_get(&history, HISTORY_FRAME, HISTORY_FPS, 0) == NULL);
+
+    for (int i = 0; i < 10; i++) {
+        record((float)i, i * 16);
+    }
+    assert(history_count(&history, HISTORY_FRAME) == 10);
+    s = history_get(&history, HISTORY_FRAME, HISTORY_CPU_MHZ, 0);
+    assert(s && near(s->mean, 9.0f) && near(s->min, 9.0f) && near(s->max, 9.0f));
+    s = history_get(&history, HISTORY_FRAME, HISTORY_FPS, 9);
+    assert(s && near(s->mean, 0.0f + HISTORY_FPS));
+    assert(history_get(&history, HISTORY_FRAME, HISTORY_FPS, 10) == NULL);
+    assert(history_get(&history, HISTORY_FRAME, HISTORY_FPS, -1) == NULL);
+
+    printf("Testing wrap-around...\n");
+    history_init(&history);
+    int frames = HISTORY_FRAME_SLOTS + 44;
+    for (int i = 0; i < frames; i++) {
+        record((float)i, 0);
+    }
+    assert(history_count(&history, HISTORY_FRAME) == HISTORY_FRAME_SLOTS);
+    assert(history_total(&history, HISTORY_FRAME) == (uint32_t)frames);
+    s = history_get(&history, HISTORY_FRAME, HISTORY_CPU_MHZ, 0);
+    assert(near(s->mean, (float)(frames - 1)));
+    s = history_get(&history, HISTORY_FRAME, HISTORY_CPU_MHZ, HISTORY_FRAME_SLOTS - 1);
+    assert(near(s->mean, 44.0f));
+
+    printf("Testing second downsampling...\n");
+    history_init(&history);
+    // 10 frames in the first second: values 0..9
+    for (int i = 0; i < 10; i++) {
+        record((float)i, 5000 + i * 100);
+    }
+    assert(history_count(&history, HISTORY_SECOND) == 0);
+    record(100.0f, 6000);
+    assert(history_count(&history, HISTORY_SECOND) == 1);
+    s = history_get(&history, HISTORY_SECOND, HISTORY_CPU_MHZ, 0);
+    assert(near(s->min, 0.0f) && near(s->max, 9.0f) && near(s->mean, 4.5f));
+    s = history_get(&history, HISTORY_SECOND, HISTORY_SCANLINE, 0);
+    assert(near(s->min, 0.0f + HISTORY_SCANLINE) && near(s->max, 9.0f + HISTORY_SCANLINE));
+
+    printf("Testing stalls...\n");
+    // A 5 s gap closes the second holding data, and nothing else
+    record(7.0f, 11500);
+    assert(history_count(&history, HISTORY_SECOND) == 2);
+    s = history_get(&history, HISTORY_SECOND, HISTORY_CPU_MHZ, 0);
+    assert(near(s->mean, 100.0f));
+    record(8.0f, 12000);
+    assert(history_count(&history, HISTORY_SECOND) == 3);
+    s = history_get(&history, HISTORY_SECOND, HISTORY_CPU_MHZ, 0);
+    assert(near(s->mean, 7.0f));
+
+    printf("Testing minute downsampling...\n");
+    history_init(&history);
+    // Second k holds the values k and k + 2, so its mean is k + 1
+    uint32_t t = 0;
+    for (int k = 0; k < 60; k++) {
+        record((float)k, t);
+        record((float)k + 2.0f, t + 500);
+        t += 1000;
+    }
+    assert(history_count(&history, HISTORY_MINUTE) == 0);
+    record(0.0f, t);
+    assert(history_count(&history, HISTORY_SECOND) == 60);
+    assert(history_count(&history, HISTORY_MINUTE) == 1);
+    s = history_get(&history, HISTORY_MINUTE, HISTORY_CPU_MHZ, 0);
+    assert(near(s->min, 0.0f) && near(s->max, 61.0f) && near(s->mean, 30.5f));
+
+    printf("Testing clock wrap...\n");
+    history_init(&history);
+    record(1.0f, UINT32_MAX - 500);
+    record(2.0f, 499);
+    assert(history_count(&history, HISTORY_SECOND) == 1);
+
+    printf("All history tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,138 @@
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "stats.h"
+
+#define SAMPLES 20000
+
+static int compare_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Deterministic uniform values in [0, 1)
+static double next_uniform(unsigned *state) {
+    *state = *state * 1103515245u + 12345u;
+    return ((*state >> 8) & 0xFFFF) / 65536.0;
+}
+
+static int near(double a, double b, double tolerance) {
+    return fabs(a - b) <= tolerance;
+}
+
+static void check_quantile(const double *sorted, int n, double p, const StatsQuantile *q, double tolerance) {
+    double exact = sorted[(int)ceil(p * n) - 1];
+    double estimate = stats_quantile_get(q);
+    printf("  p%.0f: exact %.4f, estimate %.4f\n", p * 100, exact, estimate);
+    assert(near(exact, estimate, tolerance));
+}
+
+int main(void) {
+    static double values[SAMPLES];
+    unsigned state = 1;
+
+    printf("Testing running mean and variance...\n");
+    StatsRunning r;
+    stats_running_init(&r);
+    assert(stats_running_variance(&r) == 0.0);
+    const double small[] = { 2, 4, 4, 4, 5, 5, 7, 9 };
+    for (int i = 0; i < 8; i++) {
+        stats_running_add(&r, small[i]);
+    }
+    assert(r.n == 8);
+    assert(near(r.mean, 5.0, 1e-12));
+    assert(near(stats_running_variance(&r), 32.0 / 7.0, 1e-12));
+    assert(r.min == 2 && r.max == 9);
+
+    // A large offset must not cost precision
+    stats_running_init(&r);
+    for (int i = 0; i < 1000; i++) {
+        stats_running_add(&r, 1e9 + (i % 2));
+    }
+    assert(near(stats_running_variance(&r), 0.25 * 1000 / 999, 1e-6));
+
+    printf("Testing quantiles with few samples...\n");
+    StatsQuantile q;
+    stats_quantile_init(&q, 0.5);
+    assert(stats_quantile_get(&q) == 0.0);
+    stats_quantile_add(&q, 3);
+    stats_quantile_add(&q, 1);
+    stats_quantile_add(&q, 2);
+    assert(stats_quantile_get(&q) == 2);
+
+    printf("Testing quantiles against exact values...\n");
+    StatsQuantile p50, p90, p99;
+    stats_quantile_init(&p50, 0.50);
+    stats_quantile_init(&p90, 0.90);
+    stats_quantile_init(&p99, 0.99);
+    for (int i = 0; i < SAMPLES; i++) {
+        // Mostly flat with a tail, like frame times with hitches
+        double u = next_uniform(&state);
+        values[i] = u < 0.95 ? 16.0 + u : 20.0 + 40.0 * next_uniform(&state);
+        stats_quantile_add(&p50, values[i]);
+        stats_quantile_add(&p90, values[i]);
+        stats_quantile_add(&p99, values[i]);
+    }
+    qsort(values, SAMPLES, sizeof(values[0]), compare_double);
+    check_quantile(values, SAMPLES, 0.50, &p50, 0.02);
+    check_quantile(values, SAMPLES, 0.90, &p90, 0.05);
+    check_quantile(values, SAMPLES, 0.99, &p99, 2.0);
+
+    printf("Testing regression slope...\n");
+    StatsRegression g;
+    stats_regression_init(&g);
+    assert(stats_regression_slope(&g) == 0.0);
+    stats_regression_add(&g, 1.0, 5.0);
+    stats_regression_add(&g, 1.0, 7.0);
+    assert(stats_regression_slope(&g) == 0.0);      // No spread in x
+    stats_regression_init(&g);
+    for (int i = 0; i < 1000; i++) {
+        double noise = next_uniform(&state) - 0.5;
+        stats_regression_add(&g, i * 0.01, 100.0 - 2.5 * i * 0.01 + noise);
+    }
+    assert(near(stats_regression_slope(&g), -2.5, 0.02));
+
+    printf("Testing Welch's t-test...\n");
+    assert(stats_t95(1) == 12.706);
+    assert(stats_t95(10.9) == 2.228);
+    assert(near(stats_t95(60), 2.000, 0.002));
+    assert(near(stats_t95(1e9), 1.960, 1e-6));
+    StatsRunning a, b;
+    stats_running_init(&a);
+    stats_running_init(&b);
+    const double sample_a[] = { 20, 22, 19, 20, 22, 18 };
+    const double sample_b[] = { 24, 25, 22, 26, 23, 24 };
+    stats_running_add(&a, sample_a[0]);
+    stats_running_add(&b, sample_b[0]);
+    StatsWelch w = stats_welch(&a, &b);
+    assert(!w.significant && w.se == 0.0);      // One value each
+    for (int i = 1; i < 6; i++) {
+        stats_running_add(&a, sample_a[i]);
+        stats_running_add(&b, sample_b[i]);
+    }
+    w = stats_welch(&a, &b);
+    assert(near(w.diff, 3.8333, 1e-4));
+    assert(near(w.se, 0.8724, 1e-4));
+    assert(near(w.df, 9.8484, 1e-4));
+    assert(near(w.t, 4.3939, 1e-4));
+    assert(near(w.ci95, 2.262 * w.se, 1e-9));
+    assert(w.significant);
+    // Overlapping samples are not told apart
+    w = stats_welch(&a, &a);
+    assert(w.diff == 0.0 && !w.significant);
+    // Noise-free scores differ as soon as the means do
+    stats_running_init(&a);
+    stats_running_init(&b);
+    for (int i = 0; i < 4; i++) {
+        stats_running_add(&a, 7.0);
+        stats_running_add(&b, 8.0);
+    }
+    w = stats_welch(&a, &b);
+    assert(w.se == 0.0 && w.significant);
+    assert(!stats_welch(&a, &a).significant);
+
+    printf("All stats tests passed!\n");
+    return 0;
+}
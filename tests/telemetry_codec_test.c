@@ -0,0 +1,161 @@
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "telemetry_codec.h"
+
+static void check_varint(uint32_t value, size_t expected_len) {
+    uint8_t buffer[8];
+    uint32_t decoded = 0;
+    size_t len = telemetry_put_varint(buffer, value);
+    assert(len == expected_len);
+    assert(telemetry_get_varint(buffer, len, &decoded) == len);
+    assert(decoded == value);
+    // One byte short must fail
+    assert(telemetry_get_varint(buffer, len - 1, &decoded) == 0);
+}
+
+static void check_base64(const char *plain, const char *encoded) {
+    char text[64];
+    uint8_t bytes[64];
+    size_t len = strlen(plain);
+    assert(telemetry_base64_encode((const uint8_t *)plain, len, text) == strlen(encoded));
+    assert(strcmp(text, encoded) == 0);
+    assert(telemetry_base64_decode(encoded, strlen(encoded), bytes) == (long)len);
+    assert(memcmp(bytes, plain, len) == 0);
+}
+
+static void make_record(int i, int32_t values[TELEMETRY_FIELD_COUNT]) {
+    values[TELEMETRY_VI_FRAMES] = i;
+    values[TELEMETRY_CPU_KHZ] = 93750 + (i % 3) - 1;
+    values[TELEMETRY_BANDWIDTH] = 480 + (i * 7) % 11;
+    values[TELEMETRY_FPS_X100] = 6000 - (i % 5 == 0 ? 3000 : 0);
+    values[TELEMETRY_SCANLINE] = (i * 37) % 525;
+    values[TELEMETRY_VI_PER_SEC] = 60;
+    values[TELEMETRY_IRQ_LOAD_X100] = i % 40;
+}
+
+int main(void) {
+    uint8_t frame[TELEMETRY_FRAME_MAX];
+    int32_t values[TELEMETRY_FIELD_COUNT];
+    int32_t decoded[TELEMETRY_FIELD_COUNT];
+    uint32_t seq;
+
+    printf("Testing zigzag...\n");
+    assert(telemetry_zigzag(0) == 0);
+    assert(telemetry_zigzag(-1) == 1);
+    assert(telemetry_zigzag(1) == 2);
+    assert(telemetry_zigzag(INT32_MAX) == UINT32_MAX - 1);
+    assert(telemetry_zigzag(INT32_MIN) == UINT32_MAX);
+    assert(telemetry_unzigzag(telemetry_zigzag(INT32_MIN)) == INT32_MIN);
+    assert(telemetry_unzigzag(telemetry_zigzag(-12345)) == -12345);
+
+    printf("Testing varints...\n");
+    check_varint(0, 1);
+    check_varint(127, 1);
+    check_varint(128, 2);
+    check_varint(16383, 2);
+    check_varint(16384, 3);
+    check_varint(UINT32_MAX, 5);
+
+    printf("Testing CRC-16...\n");
+    // CRC-16/CCITT-FALSE check value
+    assert(telemetry_crc16((const uint8_t *)"123456789", 9) == 0x29B1);
+
+    printf("Testing base64...\n");
+    check_base64("", "");
+    check_base64("f", "Zg==");
+    check_base64("fo", "Zm8=");
+    check_base64("foo", "Zm9v");
+    check_base64("foobar", "Zm9vYmFy");
+    assert(telemetry_base64_decode("Zm9", 3, frame) == -1);
+    assert(telemetry_base64_decode("Zm9*", 4, frame) == -1);
+    assert(telemetry_base64_decode("Zg==Zg==", 8, frame) == -1);
+
+    printf("Testing record round trip...\n");
+    TelemetryEncoder enc;
+    TelemetryDecoder dec;
+    telemetry_encoder_init(&enc);
+    telemetry_decoder_init(&dec);
+    size_t key_len = 0, delta_len = 0;
+    for (int i = 0; i < 100; i++) {
+        make_record(i, values);
+        size_t len = telemetry_encode(&enc, values, frame);
+        assert(len <= TELEMETRY_FRAME_MAX);
+        if (i == 0) key_len = len;
+        if (i == 2) delta_len = len;
+        assert(telemetry_decode(&dec, frame, len, decoded, &seq) == TELEMETRY_OK);
+        assert(seq == (uint32_t)i);
+        assert(memcmp(values, decoded, sizeof(values)) == 0);
+    }
+    // Small deltas take one byte per field
+    assert(delta_len < key_len);
+    assert(delta_len <= 3 + TELEMETRY_FIELD_COUNT + 2);
+
+    printf("Testing counter wrap...\n");
+    telemetry_encoder_init(&enc);
+    telemetry_decoder_init(&dec);
+    make_record(0, values);
+    values[TELEMETRY_VI_FRAMES] = INT32_MAX;
+    size_t len = telemetry_encode(&enc, values, frame);
+    assert(telemetry_decode(&dec, frame, len, decoded, &seq) == TELEMETRY_OK);
+    values[TELEMETRY_VI_FRAMES] = INT32_MIN;
+    len = telemetry_encode(&enc, values, frame);
+    assert(telemetry_decode(&dec, frame, len, decoded, &seq) == TELEMETRY_OK);
+    assert(decoded[TELEMETRY_VI_FRAMES] == INT32_MIN);
+
+    printf("Testing corruption...\n");
+    len = telemetry_encode(&enc, values, frame);
+    frame[3] ^= 0x01;
+    assert(telemetry_decode(&dec, frame, len, decoded, &seq) == TELEMETRY_ERR_CRC);
+    frame[3] ^= 0x01;
+    frame[0] = 0;
+    assert(telemetry_decode(&dec, frame, len, decoded, &seq) == TELEMETRY_ERR_MAGIC);
+    assert(telemetry_decode(&dec, frame, 4, decoded, &seq) == TELEMETRY_ERR_SHORT);
+
+    printf("Testing resync after a gap...\n");
+    telemetry_encoder_init(&enc);
+    telemetry_decoder_init(&dec);
+    for (int i = 0; i < 2 * TELEMETRY_KEY_EVERY; i++) {
+        make_record(i, values);
+        len = telemetry_encode(&enc, values, frame);
+        if (i >= 5 && i < 10) {
+            continue;   // Dropped records
+        }
+        TelemetryStatus status = telemetry_decode(&dec, frame, len, decoded, &seq);
+        if (i >= 10 && i < TELEMETRY_KEY_EVERY) {
+            assert(status == TELEMETRY_ERR_UNSYNCED);
+        } else {
+            assert(status == TELEMETRY_OK);
+            assert(memcmp(values, decoded, sizeof(values)) == 0);
+        }
+    }
+
+    printf("Testing trace frames...\n");
+    static TelemetryTrace trace, trace_out;
+    uint8_t trace_frame[TELEMETRY_TRACE_FRAME_MAX];
+    trace.frame = 1234;
+    trace.count_khz = 46875;
+    trace.start = UINT32_MAX - 100;
+    trace.ticks = 781250;
+    trace.count = TELEMETRY_TRACE_MAX;
+    for (int i = 0; i < trace.count; i++) {
+        trace.slices[i].name = (uint8_t)(i % TELEMETRY_SLICE_COUNT);
+        trace.slices[i].start = (uint32_t)i * 30000;
+        trace.slices[i].ticks = 700000 - (uint32_t)i * 29000;
+    }
+    len = telemetry_encode_trace(&trace, trace_frame);
+    assert(len <= TELEMETRY_TRACE_FRAME_MAX);
+    assert(telemetry_frame_type(trace_frame, len) == TELEMETRY_TRACE);
+    assert(telemetry_decode_trace(trace_frame, len, &trace_out) == TELEMETRY_OK);
+    assert(memcmp(&trace, &trace_out, sizeof(trace)) == 0);
+    // Trace and record frames are not interchangeable
+    assert(telemetry_decode(&dec, trace_frame, len, decoded, &seq) == TELEMETRY_ERR_TYPE);
+    assert(telemetry_decode_trace(frame, telemetry_encode(&enc, values, frame), &trace_out) == TELEMETRY_ERR_TYPE);
+    trace_frame[len - 1] ^= 0x80;
+    assert(telemetry_decode_trace(trace_frame, len, &trace_out) == TELEMETRY_ERR_CRC);
+
+    printf("All telemetry codec tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,401 @@
+// Host-side decoder for the ROM's telemetry stream.
+//
+// Reads a debug log (file or stdin), decodes every "@T " line and prints a
+// per-metric summary as CSV (default) or JSON. Optionally writes every
+// decoded record to a CSV file, and the trace frames as Chrome trace JSON
+// (chrome://tracing, ui.perfetto.dev). Memory use does not depend on the
+// capture length: each metric keeps running stats, three P-square
+// quantiles and a drift regression, and trace events are written as they
+// are decoded.
+//
+// Usage: telemetry_report [-j] [-r records.csv] [-t trace.json] [-z refresh_hz] [capture.log]
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "stats.h"
+#include "telemetry_codec.h"
+
+#define LINE_LEN        512
+#define OUTLIER_SIGMA   4.0     // Distance from the running mean, in stddevs
+#define OUTLIER_WARMUP  30      // Samples before outliers are flagged
+
+// Summary metrics, in display units (vi_frames is the time base instead)
+typedef struct {
+    TelemetryField field;
+    const char *name;
+    double scale;
+} Metric;
+
+static const Metric metrics[] = {
+    { TELEMETRY_CPU_KHZ,       "cpu_mhz",        0.001 },
+    { TELEMETRY_BANDWIDTH,     "bandwidth_mbps", 1.0 },
+    { TELEMETRY_FPS_X100,      "fps",            0.01 },
+    { TELEMETRY_SCANLINE,      "scanline",       1.0 },
+    { TELEMETRY_VI_PER_SEC,    "vi_per_sec",     1.0 },
+    { TELEMETRY_IRQ_LOAD_X100, "irq_load_pct",   0.01 },
+};
+#define METRIC_COUNT (int)(sizeof(metrics) / sizeof(metrics[0]))
+
+typedef struct {
+    StatsRunning running;
+    StatsQuantile p50;
+    StatsQuantile p90;
+    StatsQuantile p99;
+    StatsRegression drift;      // Value over time in hours
+    uint32_t outliers;
+} MetricStats;
+
+typedef struct {
+    uint32_t lines;
+    uint32_t records;
+    uint32_t missing;           // Sequence numbers never decoded
+    uint32_t corrupt;           // Bad base64, magic, CRC or length
+    uint32_t unsynced;          // Deltas skipped while waiting for a key frame
+    uint32_t restarts;          // Sequence went back to 0 (stream re-enabled)
+    uint32_t traces;            // Trace frames decoded
+    uint32_t traces_missing;    // Gaps in the trace frame numbers
+    double refresh_hz;
+    uint32_t first_vi;
+    double duration_s;
+    uint32_t last_seq;
+    int have_record;
+    MetricStats stats[METRIC_COUNT];
+} Report;
+
+// Chrome trace output. Frames carry wrapping COUNT timestamps, so time is
+// accumulated frame to frame, each step converted at that frame's clock.
+typedef struct {
+    FILE *out;
+    uint32_t last_frame;
+    uint32_t last_start;
+    double frame_us;            // Start of the last frame, from the first one
+} TraceWriter;
+
+#define TRACE_PID       1
+#define TRACE_TID_FRAME TELEMETRY_TRACK_COUNT   // Frame boundaries get a row
+
+// Print with a fixed precision, without a "-0.000"
+static void print_number(FILE *out, double v, int decimals) {
+    double half = 0.5 * pow(10.0, -decimals);
+    if (fabs(v) < half) {
+        v = 0.0;
+    }
+    fprintf(out, "%.*f", decimals, v);
+}
+
+static void report_init(Report *r, double refresh_hz) {
+    memset(r, 0, sizeof(*r));
+    r->refresh_hz = refresh_hz;
+    for (int m = 0; m < METRIC_COUNT; m++) {
+        MetricStats *s = &r->stats[m];
+        stats_running_init(&s->running);
+        stats_quantile_init(&s->p50, 0.50);
+        stats_quantile_init(&s->p90, 0.90);
+        stats_quantile_init(&s->p99, 0.99);
+        stats_regression_init(&s->drift);
+    }
+}
+
+static void report_record(Report *r, const int32_t values[TELEMETRY_FIELD_COUNT], uint32_t seq,
+                          FILE *records) {
+    if (!r->have_record) {
+        // Without -z, take the TV standard from the first measured VI rate
+        if (r->refresh_hz <= 0.0) {
+            r->refresh_hz = values[TELEMETRY_VI_PER_SEC] < 55 ? 50.0 : 60.0;
+        }
+        r->first_vi = (uint32_t)values[TELEMETRY_VI_FRAMES];
+    } else if (seq <= r->last_seq) {
+        r->restarts++;
+    } else {
+        r->missing += seq - r->last_seq - 1;
+    }
+    r->have_record = 1;
+    r->last_seq = seq;
+    r->records++;
+
+    // The VI counter keeps running across restarts and wraps modulo 2^32
+    double t = ((uint32_t)values[TELEMETRY_VI_FRAMES] - r->first_vi) / r->refresh_hz;
+    r->duration_s = t;
+
+    if (records) {
+        fprintf(records, "%lu,", (unsigned long)seq);
+        print_number(records, t, 3);
+        for (int m = 0; m < METRIC_COUNT; m++) {
+            fputc(',', records);
+            print_number(records, values[metrics[m].field] * metrics[m].scale, 3);
+        }
+        fputc('\n', records);
+    }
+
+    for (int m = 0; m < METRIC_COUNT; m++) {
+        MetricStats *s = &r->stats[m];
+        double x = values[metrics[m].field] * metrics[m].scale;
+
+        // Judged against the samples before it, so a spike cannot hide itself
+        if (s->running.n >= OUTLIER_WARMUP &&
+            fabs(x - s->running.mean) > OUTLIER_SIGMA * stats_running_stddev(&s->running)) {
+            s->outliers++;
+        }
+
+        stats_running_add(&s->running, x);
+        stats_quantile_add(&s->p50, x);
+        stats_quantile_add(&s->p90, x);
+        stats_quantile_add(&s->p99, x);
+        stats_regression_add(&s->drift, t / 3600.0, x);
+    }
+}
+
+static void trace_begin(TraceWriter *w) {
+    fprintf(w->out, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+    fprintf(w->out, "{\"ph\": \"M\", \"pid\": %d, \"name\": \"process_name\", \"args\": {\"name\": \"N64\"}}",
+            TRACE_PID);
+    for (int t = 0; t <= TRACE_TID_FRAME; t++) {
+        const char *name = t < TELEMETRY_TRACK_COUNT ? telemetry_track_names[t] : "Frames";
+        fprintf(w->out, ",\n{\"ph\": \"M\", \"pid\": %d, \"tid\": %d, \"name\": \"thread_name\", "
+                "\"args\": {\"name\": \"%s\"}}", TRACE_PID, t, name);
+        fprintf(w->out, ",\n{\"ph\": \"M\", \"pid\": %d, \"tid\": %d, \"name\": \"thread_sort_index\", "
+                "\"args\": {\"sort_index\": %d}}", TRACE_PID, t, t);
+    }
+}
+
+static void trace_slice(TraceWriter *w, int tid, const char *name, uint32_t frame, double ts, double dur) {
+    fprintf(w->out, ",\n{\"ph\": \"X\", \"pid\": %d, \"tid\": %d, \"name\": \"%s\", \"ts\": ",
+            TRACE_PID, tid, name);
+    print_number(w->out, ts, 3);
+    fprintf(w->out, ", \"dur\": ");
+    print_number(w->out, dur, 3);
+    fprintf(w->out, ", \"args\": {\"frame\": %lu}}", (unsigned long)frame);
+}
+
+static void trace_frame(Report *r, TraceWriter *w, const TelemetryTrace *t) {
+    if (t->count_khz == 0) {
+        return;
+    }
+    double us_per_tick = 1000.0 / t->count_khz;
+
+    if (r->traces > 0) {
+        if (t->frame > w->last_frame) {
+            r->traces_missing += t->frame - w->last_frame - 1;
+        }
+        // Valid while frames arrive less than 2^32 ticks (~90 s) apart
+        w->frame_us += (uint32_t)(t->start - w->last_start) * us_per_tick;
+    }
+    r->traces++;
+    w->last_frame = t->frame;
+    w->last_start = t->start;
+
+    if (!w->out) {
+        return;
+    }
+
+    char name[32];
+    snprintf(name, sizeof(name), "Frame %lu", (unsigned long)t->frame);
+    trace_slice(w, TRACE_TID_FRAME, name, t->frame, w->frame_us, t->ticks * us_per_tick);
+
+    for (int i = 0; i < t->count; i++) {
+        const TelemetrySlice *s = &t->slices[i];
+        trace_slice(w, telemetry_slice_tracks[s->name], telemetry_slice_names[s->name], t->frame,
+                    w->frame_us + s->start * us_per_tick, s->ticks * us_per_tick);
+    }
+}
+
+static void trace_end(TraceWriter *w) {
+    fprintf(w->out, "\n]}\n");
+}
+
+static void report_line(Report *r, TelemetryDecoder *dec, TraceWriter *w, char *line, FILE *records) {
+    static TelemetryTrace trace;
+    uint8_t frame[LINE_LEN];
+    int32_t values[TELEMETRY_FIELD_COUNT];
+    uint32_t seq;
+
+    r->lines++;
+
+    // Other debug output shares the channel
+    char *text = strstr(line, TELEMETRY_LINE_PREFIX);
+    if (!text) {
+        return;
+    }
+    text += strlen(TELEMETRY_LINE_PREFIX);
+    size_t len = strcspn(text, "\r\n");
+
+    long frame_len = telemetry_base64_decode(text, len, frame);
+    if (frame_len < 0) {
+        r->corrupt++;
+        return;
+    }
+
+    if (telemetry_frame_type(frame, (size_t)frame_len) == TELEMETRY_TRACE) {
+        if (telemetry_decode_trace(frame, (size_t)frame_len, &trace) == TELEMETRY_OK) {
+            trace_frame(r, w, &trace);
+        } else {
+            r->corrupt++;
+        }
+        return;
+    }
+
+    TelemetryStatus status = telemetry_decode(dec, frame, (size_t)frame_len, values, &seq);
+    if (status == TELEMETRY_OK) {
+        report_record(r, values, seq, records);
+    } else if (status == TELEMETRY_ERR_UNSYNCED) {
+        r->unsynced++;
+    } else {
+        r->corrupt++;
+    }
+}
+
+static void print_csv(const Report *r) {
+    printf("metric,count,min,mean,stddev,p50,p90,p99,max,drift_per_hour,outliers\n");
+    for (int m = 0; m < METRIC_COUNT; m++) {
+        const MetricStats *s = &r->stats[m];
+        printf("%s,%lu,", metrics[m].name, (unsigned long)s->running.n);
+        print_number(stdout, s->running.min, 3);
+        putchar(',');
+        print_number(stdout, s->running.mean, 3);
+        putchar(',');
+        print_number(stdout, stats_running_stddev(&s->running), 3);
+        putchar(',');
+        print_number(stdout, stats_quantile_get(&s->p50), 3);
+        putchar(',');
+        print_number(stdout, stats_quantile_get(&s->p90), 3);
+        putchar(',');
+        print_number(stdout, stats_quantile_get(&s->p99), 3);
+        putchar(',');
+        print_number(stdout, s->running.max, 3);
+        putchar(',');
+        print_number(stdout, stats_regression_slope(&s->drift), 3);
+        printf(",%lu\n", (unsigned long)s->outliers);
+    }
+}
+
+static void print_json(const Report *r) {
+    printf("{\n");
+    printf("  \"lines\": %lu,\n", (unsigned long)r->lines);
+    printf("  \"records\": %lu,\n", (unsigned long)r->records);
+    printf("  \"missing\": %lu,\n", (unsigned long)r->missing);
+    printf("  \"corrupt\": %lu,\n", (unsigned long)r->corrupt);
+    printf("  \"unsynced\": %lu,\n", (unsigned long)r->unsynced);
+    printf("  \"restarts\": %lu,\n", (unsigned long)r->restarts);
+    printf("  \"traces\": %lu,\n", (unsigned long)r->traces);
+    printf("  \"traces_missing\": %lu,\n", (unsigned long)r->traces_missing);
+    printf("  \"refresh_hz\": ");
+    print_number(stdout, r->refresh_hz, 3);
+    printf(",\n  \"duration_s\": ");
+    print_number(stdout, r->duration_s, 3);
+    printf(",\n  \"metrics\": {\n");
+
+    for (int m = 0; m < METRIC_COUNT; m++) {
+        const MetricStats *s = &r->stats[m];
+        printf("    \"%s\": {\"count\": %lu, \"min\": ", metrics[m].name, (unsigned long)s->running.n);
+        print_number(stdout, s->running.min, 3);
+        printf(", \"mean\": ");
+        print_number(stdout, s->running.mean, 3);
+        printf(", \"stddev\": ");
+        print_number(stdout, stats_running_stddev(&s->running), 3);
+        printf(", \"p50\": ");
+        print_number(stdout, stats_quantile_get(&s->p50), 3);
+        printf(", \"p90\": ");
+        print_number(stdout, stats_quantile_get(&s->p90), 3);
+        printf(", \"p99\": ");
+        print_number(stdout, stats_quantile_get(&s->p99), 3);
+        printf(", \"max\": ");
+        print_number(stdout, s->running.max, 3);
+        printf(", \"drift_per_hour\": ");
+        print_number(stdout, stats_regression_slope(&s->drift), 3);
+        printf(", \"outliers\": %lu}%s\n", (unsigned long)s->outliers, m + 1 < METRIC_COUNT ? "," : "");
+    }
+    printf("  }\n}\n");
+}
+
+static void usage(void) {
+    fprintf(stderr, "usage: telemetry_report [-j] [-r records.csv] [-t trace.json] [-z refresh_hz] [capture.log]\n");
+}
+
+int main(int argc, char **argv) {
+    static Report report;
+    TelemetryDecoder dec;
+    TraceWriter trace = {0};
+    char line[LINE_LEN];
+    const char *input = NULL;
+    const char *records_path = NULL;
+    const char *trace_path = NULL;
+    double refresh_hz = 0.0;
+    int json = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-j") == 0) {
+            json = 1;
+        } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            records_path = argv[++i];
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            trace_path = argv[++i];
+        } else if (strcmp(argv[i], "-z") == 0 && i + 1 < argc) {
+            refresh_hz = atof(argv[++i]);
+        } else if (argv[i][0] == '-' || input) {
+            usage();
+            return 2;
+        } else {
+            input = argv[i];
+        }
+    }
+
+    FILE *in = input ? fopen(input, "r") : stdin;
+    if (!in) {
+        perror(input);
+        return 1;
+    }
+
+    FILE *records = NULL;
+    if (records_path) {
+        if (!(records = fopen(records_path, "w"))) {
+            perror(records_path);
+            return 1;
+        }
+        fprintf(records, "seq,time_s");
+        for (int m = 0; m < METRIC_COUNT; m++) {
+            fprintf(records, ",%s", metrics[m].name);
+        }
+        fputc('\n', records);
+    }
+
+    if (trace_path) {
+        if (!(trace.out = fopen(trace_path, "w"))) {
+            perror(trace_path);
+            return 1;
+        }
+        trace_begin(&trace);
+    }
+
+    report_init(&report, refresh_hz);
+    telemetry_decoder_init(&dec);
+
+    while (fgets(line, sizeof(line), in)) {
+        // Skip the rest of an overlong line; it cannot be a record
+        if (!strchr(line, '\n') && !feof(in)) {
+            int c;
+            while ((c = fgetc(in)) != EOF && c != '\n') {
+            }
+            report.lines++;
+            continue;
+        }
+        report_line(&report, &dec, &trace, line, records);
+    }
+
+    if (input) fclose(in);
+    if (records) fclose(records);
+    if (trace.out) {
+        trace_end(&trace);
+        fclose(trace.out);
+    }
+
+    if (json) {
+        print_json(&report);
+    } else {
+        print_csv(&report);
+    }
+    return 0;
+}